@@ -0,0 +1,184 @@
+#include "AstronomyCache.h"
+#include "CivilDate.h"
+#include <cmath>
+#include <cstring>
+
+namespace {
+
+// splitmix64 finalizer
+uint64_t mix(uint64_t x) {
+    x ^= x >> 30;
+    x *= 0xbf58476d1ce4e5b9ULL;
+    x ^= x >> 27;
+    x *= 0x94d049bb133111ebULL;
+    return x ^ (x >> 31);
+}
+
+}
+
+uint64_t AstronomyCache::KeyHash::hash(const Key& key) {
+    uint64_t date = ((uint64_t)(uint32_t)key.localDay << 32) | (uint32_t)key.utcOffset;
+    return mix((uint64_t)key.latitude ^ mix((uint64_t)key.longitude ^ mix(date)));
+}
+
+void AstronomyCache::Shard::unlink(uint32_t slot) {
+    Entry& entry = entries[slot];
+    if (entry.newer != NONE) entries[entry.newer].older = entry.older;
+    else newest = entry.older;
+    if (entry.older != NONE) entries[entry.older].newer = entry.newer;
+    else oldest = entry.newer;
+}
+
+void AstronomyCache::Shard::pushNewest(uint32_t slot) {
+    Entry& entry = entries[slot];
+    entry.newer = NONE;
+    entry.older = newest;
+    if (newest != NONE) entries[newest].newer = slot;
+    newest = slot;
+    if (oldest == NONE) oldest = slot;
+}
+
+// Constructor - preallocates every shard
+AstronomyCache::AstronomyCache(size_t capacity, double quantumDegrees, int shards)
+    : quantumDegrees(quantumDegrees > 0.0 ? quantumDegrees : 0.0),
+      totalCapacity(capacity > 0 ? capacity : 1) {
+
+    // Every shard holds at least one entry, so never more shards than entries
+    shardCount = shards > 0 ? (size_t)shards : 1;
+    if (shardCount > totalCapacity) shardCount = totalCapacity;
+    this->shards.reset(new Shard[shardCount]);
+
+    // Split the bound exactly; the first shards take the remainder
+    for (size_t i = 0; i < shardCount; i++) {
+        Shard& shard = this->shards[i];
+        shard.limit = totalCapacity / shardCount + (i < totalCapacity % shardCount ? 1 : 0);
+        shard.entries.reserve(shard.limit);
+        shard.index.reserve(shard.limit);
+    }
+}
+
+// Key for a request; false if the time has no local date
+bool AstronomyCache::makeKey(double lat, double lng, time_t unixTime, Key* key) const {
+    struct tm local;
+    if (localtime_r(&unixTime, &local) == nullptr) return false;
+
+    int32_t localDay = (int32_t)daysFromCivil(local.tm_year + 1900, local.tm_mon + 1, local.tm_mday);
+    int32_t secondOfDay = local.tm_hour * 3600 + local.tm_min * 60 + local.tm_sec;
+    int64_t localSeconds = (int64_t)localDay * 86400 + secondOfDay;
+
+    if (quantumDegrees > 0.0) {
+        key->latitude = llround(lat / quantumDegrees);
+        key->longitude = llround(lng / quantumDegrees);
+    } else {
+        memcpy(&key->latitude, &lat, sizeof(lat));
+        memcpy(&key->longitude, &lng, sizeof(lng));
+    }
+    key->localDay = localDay;
+    key->utcOffset = (int32_t)(localSeconds - (int64_t)unixTime);
+    return true;
+}
+
+// Coordinates a key's events are solved at
+void AstronomyCache::keyCentre(const Key& key, double* lat, double* lng) const {
+    if (quantumDegrees > 0.0) {
+        *lat = key.latitude * quantumDegrees;
+        *lng = key.longitude * quantumDegrees;
+    } else {
+        memcpy(lat, &key.latitude, sizeof(*lat));
+        memcpy(lng, &key.longitude, sizeof(*lng));
+    }
+}
+
+AstronomyCache::Shard& AstronomyCache::shardFor(const Key& key) {
+    // High bits pick the shard; the map buckets use the low bits. Shift the
+    // 64-bit hash, not size_t, which is only 32 bits on the ESP32
+    return shards[(size_t)((KeyHash::hash(key) >> 40) % shardCount)];
+}
+
+bool AstronomyCache::find(Shard& shard, const Key& key, AstronomyDayEvents* events) {
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    auto it = shard.index.find(key);
+    if (it == shard.index.end()) {
+        shard.misses++;
+        return false;
+    }
+
+    uint32_t slot = it->second;
+    *events = shard.entries[slot].events;
+    if (shard.newest != slot) {
+        shard.unlink(slot);
+        shard.pushNewest(slot);
+    }
+    shard.hits++;
+    return true;
+}
+
+void AstronomyCache::insert(Shard& shard, const Key& key, const AstronomyDayEvents& events) {
+    std::lock_guard<std::mutex> lock(shard.mutex);
+
+    // Another thread may have filled it while we were calculating
+    auto it = shard.index.find(key);
+    if (it != shard.index.end()) return;
+
+    uint32_t slot;
+    if (shard.entries.size() < shard.limit) {
+        slot = (uint32_t)shard.entries.size();
+        shard.entries.push_back(Entry());
+    } else {
+        slot = shard.oldest;
+        shard.unlink(slot);
+        shard.index.erase(shard.entries[slot].key);
+        shard.evictions++;
+    }
+
+    shard.entries[slot].key = key;
+    shard.entries[slot].events = events;
+    shard.pushNewest(slot);
+    shard.index.emplace(key, slot);
+}
+
+// Rise/set solutions for the request's bucket and local date
+AstronomyDayEvents AstronomyCache::dayEvents(double lat, double lng, time_t unixTime) {
+    Key key;
+    if (!makeKey(lat, lng, unixTime, &key)) {
+        return AstronomyCalculator(lat, lng, unixTime).dayEvents();
+    }
+    Shard& shard = shardFor(key);
+
+    AstronomyDayEvents events;
+    if (!find(shard, key, &events)) {
+        double centreLat, centreLng;
+        keyCentre(key, &centreLat, &centreLng);
+        events = AstronomyCalculator(centreLat, centreLng, unixTime).dayEvents();
+        insert(shard, key, events);
+    }
+    return events;
+}
+
+// Results for an exact location and time, from the cache when possible
+AstronomyRecord AstronomyCache::lookup(double lat, double lng, time_t unixTime) {
+    AstronomyDayEvents events = dayEvents(lat, lng, unixTime);
+    return AstronomyCalculator::recordFromEvents(lat, lng, unixTime, events);
+}
+
+AstronomyCache::Stats AstronomyCache::stats() const {
+    Stats total = {0, 0, 0, 0};
+    for (size_t i = 0; i < shardCount; i++) {
+        std::lock_guard<std::mutex> lock(shards[i].mutex);
+        total.hits += shards[i].hits;
+        total.misses += shards[i].misses;
+        total.evictions += shards[i].evictions;
+        total.entries += shards[i].entries.size();
+    }
+    return total;
+}
+
+void AstronomyCache::clear() {
+    for (size_t i = 0; i < shardCount; i++) {
+        std::lock_guard<std::mutex> lock(shards[i].mutex);
+        shards[i].index.clear();
+        shards[i].entries.clear();
+        shards[i].newest = shards[i].oldest = NONE;
+        shards[i].hits = shards[i].misses = shards[i].evictions = 0;
+    }
+}
@@ -0,0 +1,119 @@
+#ifndef ASTRONOMY_CACHE_H
+#define ASTRONOMY_CACHE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <ctime>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+#include "AstronomyCalculator.h"
+#include "AstronomyRecord.h"
+
+// Sharded LRU cache of per-day results for a query service.
+//
+// Entries are keyed on (latitude, longitude) rounded to a multiple of the
+// quantum, the local date and the UTC offset in effect, and hold the
+// trivially copyable AstronomyDayEvents (the rise/set solves, which are
+// nearly all of the cost). A lookup rebuilds the time-of-day fields for the
+// exact request from those with AstronomyCalculator::recordFromEvents(), so
+// "minutes until" values are never stale and a hit never touches the heap.
+//
+// The calculator solves a date's events at local noon whatever the request
+// time, so a hit returns exactly what AstronomyCalculator returns for the
+// bucket centre. Off-grid coordinates get the centre's rise/set times:
+// with the default 0.01 degree quantum they stay within 2 minutes of
+// their own, away from polar day/night. A quantum of 0 keys on the exact
+// coordinates and makes the cache fully transparent.
+//
+// Timestamps the C library cannot express as local time bypass the cache.
+//
+// Keys hash to one of several independently locked shards, each with its
+// own fixed-size LRU list, so threads rarely contend. The calculation on a
+// miss runs outside the lock.
+class AstronomyCache {
+public:
+    struct Stats {
+        uint64_t hits;
+        uint64_t misses;
+        uint64_t evictions;
+        size_t entries;
+    };
+
+private:
+    struct Key {
+        int64_t latitude;  // multiples of the quantum, or the raw bits when exact
+        int64_t longitude;
+        int32_t localDay;  // days since 1970-01-01 in local time
+        int32_t utcOffset; // seconds east of UTC
+
+        bool operator==(const Key& other) const {
+            return latitude == other.latitude && longitude == other.longitude &&
+                   localDay == other.localDay && utcOffset == other.utcOffset;
+        }
+    };
+
+    struct KeyHash {
+        static uint64_t hash(const Key& key); // full 64 bits on every target
+        size_t operator()(const Key& key) const { return (size_t)hash(key); }
+    };
+
+    struct Entry {
+        Key key;
+        AstronomyDayEvents events;
+        uint32_t newer; // towards the most recently used entry
+        uint32_t older;
+    };
+
+    static constexpr uint32_t NONE = UINT32_MAX;
+
+    // Padded to a cache line so neighbouring shard locks don't false-share
+    struct alignas(64) Shard {
+        mutable std::mutex mutex;
+        std::unordered_map<Key, uint32_t, KeyHash> index;
+        std::vector<Entry> entries;
+        uint32_t newest = NONE;
+        uint32_t oldest = NONE;
+        uint64_t hits = 0;
+        uint64_t misses = 0;
+        uint64_t evictions = 0;
+        size_t limit = 0; // entry bound for this shard
+
+        void unlink(uint32_t slot);
+        void pushNewest(uint32_t slot);
+    };
+
+    double quantumDegrees;
+    size_t totalCapacity;
+    size_t shardCount;
+    std::unique_ptr<Shard[]> shards;
+
+    bool makeKey(double lat, double lng, time_t unixTime, Key* key) const;
+    void keyCentre(const Key& key, double* lat, double* lng) const;
+    Shard& shardFor(const Key& key);
+    bool find(Shard& shard, const Key& key, AstronomyDayEvents* events);
+    void insert(Shard& shard, const Key& key, const AstronomyDayEvents& events);
+
+public:
+    // Constructor - capacity is the total entry bound across all shards (the
+    // shard count is reduced if it exceeds it); quantum 0 keys on exact coordinates
+    explicit AstronomyCache(size_t capacity = 4096, double quantumDegrees = 0.01, int shards = 16);
+
+    AstronomyCache(const AstronomyCache&) = delete;
+    AstronomyCache& operator=(const AstronomyCache&) = delete;
+
+    // Results for an exact location and time, from the cache when possible
+    AstronomyRecord lookup(double lat, double lng, time_t unixTime);
+
+    // Rise/set solutions for the request's bucket and local date
+    AstronomyDayEvents dayEvents(double lat, double lng, time_t unixTime);
+
+    // Configuration and metrics (summed over shards)
+    size_t capacity() const { return totalCapacity; }
+    double quantum() const { return quantumDegrees; }
+    Stats stats() const;
+    void clear();
+};
+
+#endif
@@ -1,64 +1,146 @@
 #include "AstronomyCalculator.h"
+#include "AstronomyRecord.h"
+#include "HorizonProfile.h"
 #include <cstdio>
+#include <cstring>
 
 #ifndef M_PI
 #define M_PI 3.14159265358979323846
 #endif
 
-// Constructor - performs all calculations
+// Constructor - flat horizon
 AstronomyCalculator::AstronomyCalculator(double lat, double lng, time_t unixTime)
-    : latitude(lat), longitude(lng), timestamp(unixTime) {
+    : AstronomyCalculator(lat, lng, unixTime, nullptr) {
+}
+
+// Constructor - performs all calculations
+AstronomyCalculator::AstronomyCalculator(double lat, double lng, time_t unixTime, const HorizonProfile* horizon)
+    : latitude(lat), longitude(lng), timestamp(unixTime), horizon(horizon) {
     
     julianDay = toJulianDay(unixTime);
+    localHour = toLocalHour(unixTime);
+    
+    // Solve rise/set for yesterday, today and tomorrow at local noon, so the
+    // events of a date don't depend on the time of day they are asked for
+    double noon = toJulianDay(localNoon(unixTime));
+    events.sunrise = calcSunrise(noon, latitude, longitude);
+    events.sunset = calcSunset(noon, latitude, longitude);
+    for (int day = 0; day < 3; day++) {
+        events.moonrise[day] = calcMoonrise(noon + day - 1.0, latitude, longitude);
+        events.moonset[day] = calcMoonset(noon + day - 1.0, latitude, longitude);
+    }
+    
+    calculateFromEvents();
+    
+    // The profile need not outlive construction
+    this->horizon = nullptr;
+}
+
+// Constructor - skips the rise/set solves
+AstronomyCalculator::AstronomyCalculator(double lat, double lng, time_t unixTime, const AstronomyDayEvents& dayEvents)
+    : latitude(lat), longitude(lng), timestamp(unixTime), horizon(nullptr), events(dayEvents) {
     
-    // Convert timestamp to local hour of day
-    struct tm* timeinfo = localtime(&unixTime);
-    localHour = timeinfo->tm_hour + timeinfo->tm_min / 60.0 + timeinfo->tm_sec / 3600.0;
+    julianDay = toJulianDay(unixTime);
+    localHour = toLocalHour(unixTime);
     
+    calculateFromEvents();
+}
+
+// Derive every public member from the rise/set solutions and the time of day
+void AstronomyCalculator::calculateFromEvents() {
+    AstronomyRecord record;
+    deriveRecord(latitude, longitude, julianDay, localHour, events, horizon, &record);
+    
+    isMoonVisible = record.isMoonVisible;
+    minutesSinceLastMoonRise = record.minutesSinceLastMoonRise;
+    minutesSinceLastMoonSet = record.minutesSinceLastMoonSet;
+    minutesUntilNextMoonRise = record.minutesUntilNextMoonRise;
+    minutesUntilNextMoonSet = record.minutesUntilNextMoonSet;
+    
+    nextMoonRiseHHMM = record.nextMoonRiseHHMM;
+    nextMoonSetHHMM = record.nextMoonSetHHMM;
+    lastMoonRiseHHMM = record.lastMoonRiseHHMM;
+    lastMoonSetHHMM = record.lastMoonSetHHMM;
+    
+    sunRiseTodayHHMM = record.sunRiseTodayHHMM;
+    sunSetTodayHHMM = record.sunSetTodayHHMM;
+    minutesSinceSunRise = record.minutesSinceSunRise;
+    minutesSinceSunSet = record.minutesSinceSunSet;
+    minutesUntilSunSet = record.minutesUntilSunSet;
+    minutesUntilSunRise = record.minutesUntilSunRise;
+    
+    sunAltitudeAtRise = record.sunAltitudeAtRise;
+    sunAzimuthAtRise = record.sunAzimuthAtRise;
+    moonAltitudeAtRise = record.moonAltitudeAtRise;
+    moonAzimuthAtRise = record.moonAzimuthAtRise;
+    
+    minutesSunVisible = record.minutesSunVisible;
+    minutesMoonVisible = record.minutesMoonVisible;
+}
+
+// Results for a location and time from rise/set solutions, without building
+// a calculator (no std::string work); identical to AstronomyRecord of the
+// events constructor
+AstronomyRecord AstronomyCalculator::recordFromEvents(double lat, double lng, time_t unixTime,
+                                                      const AstronomyDayEvents& dayEvents) {
+    AstronomyRecord record;
+    memset(&record, 0, sizeof(record));
+    
+    double jd = toJulianDay(unixTime);
+    deriveRecord(lat, lng, jd, toLocalHour(unixTime), dayEvents, nullptr, &record);
+    record.moonPhaseIndex = moonPhaseIndexAt(jd);
+    return record;
+}
+
+// Derive every time-of-day result except the moon phase from the rise/set
+// solutions, at Julian day jd and local hour
+void AstronomyCalculator::deriveRecord(double lat, double lng, double jd, double hour,
+                                       const AstronomyDayEvents& events, const HorizonProfile* horizon,
+                                       AstronomyRecord* record) {
     // Calculate sun data
-    double sunriseTime = calcSunrise(julianDay, latitude, longitude);
-    double sunsetTime = calcSunset(julianDay, latitude, longitude);
+    double sunriseTime = events.sunrise;
+    double sunsetTime = events.sunset;
     
-    sunRiseTodayHHMM = formatTime(sunriseTime);
-    sunSetTodayHHMM = formatTime(sunsetTime);
+    formatClock(sunriseTime, record->sunRiseTodayHHMM);
+    formatClock(sunsetTime, record->sunSetTodayHHMM);
     
     // Calculate sun timing relative to current time
-    double hoursSinceSunrise = localHour - sunriseTime;
-    double hoursSinceSunset = localHour - sunsetTime;
-    double hoursUntilSunset = sunsetTime - localHour;
-    double hoursUntilSunrise = (sunriseTime + 24.0) - localHour; // Next day
+    double hoursSinceSunrise = hour - sunriseTime;
+    double hoursSinceSunset = hour - sunsetTime;
+    double hoursUntilSunset = sunsetTime - hour;
+    double hoursUntilSunrise = (sunriseTime + 24.0) - hour; // Next day
     
     // Handle negative values and convert to minutes
-    minutesSinceSunRise = (hoursSinceSunrise >= 0) ? hoursToMinutes(hoursSinceSunrise) : -1;
-    minutesSinceSunSet = (hoursSinceSunset >= 0) ? hoursToMinutes(hoursSinceSunset) : -1;
-    minutesUntilSunSet = (hoursUntilSunset >= 0 && hoursSinceSunset < 0) ? hoursToMinutes(hoursUntilSunset) : -1;
-    minutesUntilSunRise = (localHour > sunriseTime && localHour > sunsetTime) ? hoursToMinutes(hoursUntilSunrise) : -1;
+    record->minutesSinceSunRise = (hoursSinceSunrise >= 0) ? hoursToMinutes(hoursSinceSunrise) : -1;
+    record->minutesSinceSunSet = (hoursSinceSunset >= 0) ? hoursToMinutes(hoursSinceSunset) : -1;
+    record->minutesUntilSunSet = (hoursUntilSunset >= 0 && hoursSinceSunset < 0) ? hoursToMinutes(hoursUntilSunset) : -1;
+    record->minutesUntilSunRise = (hour > sunriseTime && hour > sunsetTime) ? hoursToMinutes(hoursUntilSunrise) : -1;
     
-    minutesSunVisible = (sunsetTime > sunriseTime) ? hoursToMinutes(sunsetTime - sunriseTime) : 0;
+    record->minutesSunVisible = (sunsetTime > sunriseTime) ? hoursToMinutes(sunsetTime - sunriseTime) : 0;
     
     // Calculate sun position at rise
-    sunAltitudeAtRise = calcSunAzEl(julianDay, sunriseTime, latitude, longitude, &sunAzimuthAtRise);
+    record->sunAltitudeAtRise = calcSunAzEl(jd, sunriseTime, lat, lng, &record->sunAzimuthAtRise);
     
     // Calculate moon data
-    double moonriseToday = calcMoonrise(julianDay, latitude, longitude);
-    double moonsetToday = calcMoonset(julianDay, latitude, longitude);
-    double moonriseYesterday = calcMoonrise(julianDay - 1.0, latitude, longitude);
-    double moonsetYesterday = calcMoonset(julianDay - 1.0, latitude, longitude);
-    double moonriseTomorrow = calcMoonrise(julianDay + 1.0, latitude, longitude);
-    double moonsetTomorrow = calcMoonset(julianDay + 1.0, latitude, longitude);
+    double moonriseToday = events.moonrise[1];
+    double moonsetToday = events.moonset[1];
+    double moonriseYesterday = events.moonrise[0];
+    double moonsetYesterday = events.moonset[0];
+    double moonriseTomorrow = events.moonrise[2];
+    double moonsetTomorrow = events.moonset[2];
     
     // Determine current moon visibility
-    isMoonVisible = isMoonCurrentlyVisible();
+    record->isMoonVisible = isMoonCurrentlyVisible(jd, hour, lat, lng, horizon);
     
     // Find most recent moonrise/moonset
     double lastMoonRise = -999, lastMoonSet = -999;
-    if (moonriseToday >= 0 && moonriseToday <= localHour) {
+    if (moonriseToday >= 0 && moonriseToday <= hour) {
         lastMoonRise = moonriseToday;
     } else if (moonriseYesterday >= 0) {
         lastMoonRise = moonriseYesterday;
     }
     
-    if (moonsetToday >= 0 && moonsetToday <= localHour) {
+    if (moonsetToday >= 0 && moonsetToday <= hour) {
         lastMoonSet = moonsetToday;
     } else if (moonsetYesterday >= 0) {
         lastMoonSet = moonsetYesterday;
@@ -66,46 +148,46 @@ AstronomyCalculator::AstronomyCalculator(double lat, double lng, time_t unixTime
     
     // Find next moonrise/moonset
     double nextMoonRise = -999, nextMoonSet = -999;
-    if (moonriseToday >= 0 && moonriseToday > localHour) {
+    if (moonriseToday >= 0 && moonriseToday > hour) {
         nextMoonRise = moonriseToday;
     } else if (moonriseTomorrow >= 0) {
         nextMoonRise = moonriseTomorrow;
     }
     
-    if (moonsetToday >= 0 && moonsetToday > localHour) {
+    if (moonsetToday >= 0 && moonsetToday > hour) {
         nextMoonSet = moonsetToday;
     } else if (moonsetTomorrow >= 0) {
         nextMoonSet = moonsetTomorrow;
     }
     
-    // Convert to member variables
-    minutesSinceLastMoonRise = (lastMoonRise > -999) ? hoursToMinutes(localHour - lastMoonRise + ((lastMoonRise > localHour) ? 24.0 : 0.0)) : -1;
-    minutesSinceLastMoonSet = (lastMoonSet > -999) ? hoursToMinutes(localHour - lastMoonSet + ((lastMoonSet > localHour) ? 24.0 : 0.0)) : -1;
-    minutesUntilNextMoonRise = (nextMoonRise > -999) ? hoursToMinutes(nextMoonRise - localHour + ((nextMoonRise < localHour) ? 24.0 : 0.0)) : -1;
-    minutesUntilNextMoonSet = (nextMoonSet > -999) ? hoursToMinutes(nextMoonSet - localHour + ((nextMoonSet < localHour) ? 24.0 : 0.0)) : -1;
+    // Convert to record fields
+    record->minutesSinceLastMoonRise = (lastMoonRise > -999) ? hoursToMinutes(hour - lastMoonRise + ((lastMoonRise > hour) ? 24.0 : 0.0)) : -1;
+    record->minutesSinceLastMoonSet = (lastMoonSet > -999) ? hoursToMinutes(hour - lastMoonSet + ((lastMoonSet > hour) ? 24.0 : 0.0)) : -1;
+    record->minutesUntilNextMoonRise = (nextMoonRise > -999) ? hoursToMinutes(nextMoonRise - hour + ((nextMoonRise < hour) ? 24.0 : 0.0)) : -1;
+    record->minutesUntilNextMoonSet = (nextMoonSet > -999) ? hoursToMinutes(nextMoonSet - hour + ((nextMoonSet < hour) ? 24.0 : 0.0)) : -1;
     
-    // Format time strings with conditional logic
-    nextMoonRiseHHMM = (isMoonVisible || nextMoonRise <= -999) ? "" : formatTime(fmod(nextMoonRise + 24.0, 24.0));
-    nextMoonSetHHMM = (nextMoonSet <= -999) ? "" : formatTime(fmod(nextMoonSet + 24.0, 24.0));
-    lastMoonRiseHHMM = (lastMoonRise <= -999) ? "" : formatTime(fmod(lastMoonRise + 24.0, 24.0));
-    lastMoonSetHHMM = (lastMoonSet <= -999) ? "" : formatTime(fmod(lastMoonSet + 24.0, 24.0));
+    // Format time strings with conditional logic; a negative hour formats as ""
+    formatClock((record->isMoonVisible || nextMoonRise <= -999) ? -1.0 : fmod(nextMoonRise + 24.0, 24.0), record->nextMoonRiseHHMM);
+    formatClock((nextMoonSet <= -999) ? -1.0 : fmod(nextMoonSet + 24.0, 24.0), record->nextMoonSetHHMM);
+    formatClock((lastMoonRise <= -999) ? -1.0 : fmod(lastMoonRise + 24.0, 24.0), record->lastMoonRiseHHMM);
+    formatClock((lastMoonSet <= -999) ? -1.0 : fmod(lastMoonSet + 24.0, 24.0), record->lastMoonSetHHMM);
     
     // Calculate moon visibility duration
     if (lastMoonRise > -999 && nextMoonSet > -999) {
         double visibleDuration = nextMoonSet - lastMoonRise;
         if (visibleDuration < 0) visibleDuration += 24.0;
-        minutesMoonVisible = hoursToMinutes(visibleDuration);
+        record->minutesMoonVisible = hoursToMinutes(visibleDuration);
     } else {
-        minutesMoonVisible = 0;
+        record->minutesMoonVisible = 0;
     }
     
     // Calculate moon position at rise
     if (nextMoonRise > -999) {
-        moonAltitudeAtRise = calcMoonAzEl(julianDay, nextMoonRise, latitude, longitude, &moonAzimuthAtRise);
+        record->moonAltitudeAtRise = calcMoonAzEl(jd, nextMoonRise, lat, lng, &record->moonAzimuthAtRise);
     } else if (lastMoonRise > -999) {
-        moonAltitudeAtRise = calcMoonAzEl(julianDay, lastMoonRise, latitude, longitude, &moonAzimuthAtRise);
+        record->moonAltitudeAtRise = calcMoonAzEl(jd, lastMoonRise, lat, lng, &record->moonAzimuthAtRise);
     } else {
-        moonAltitudeAtRise = moonAzimuthAtRise = -1;
+        record->moonAltitudeAtRise = record->moonAzimuthAtRise = -1;
     }
 }
 
@@ -114,6 +196,28 @@ double AstronomyCalculator::toJulianDay(time_t unixTime) {
     return (unixTime / 86400.0) + 2440587.5;
 }
 
+// Convert Unix timestamp to local seconds of day (reentrant, safe across
+// threads). Timestamps the C library cannot represent as local time fall
+// back to the UTC time of day rather than reading an unset struct tm.
+int AstronomyCalculator::toLocalSecondOfDay(time_t unixTime) {
+    struct tm timeinfo;
+    if (localtime_r(&unixTime, &timeinfo) == nullptr) {
+        return (int)(((unixTime % 86400) + 86400) % 86400);
+    }
+    return timeinfo.tm_hour * 3600 + timeinfo.tm_min * 60 + timeinfo.tm_sec;
+}
+
+// Convert Unix timestamp to local hour of day
+double AstronomyCalculator::toLocalHour(time_t unixTime) {
+    int second = toLocalSecondOfDay(unixTime);
+    return second / 3600 + (second / 60 % 60) / 60.0 + (second % 60) / 3600.0;
+}
+
+// Local noon of the date containing unixTime; rise/set are solved here
+time_t AstronomyCalculator::localNoon(time_t unixTime) {
+    return unixTime - toLocalSecondOfDay(unixTime) + 12 * 3600;
+}
+
 // Calculate solar declination using NOAA algorithm
 double AstronomyCalculator::calcSunDeclination(double jd) {
     double n = jd - 2451545.0;
@@ -167,10 +271,81 @@ double AstronomyCalculator::calcHourAngleSunrise(double lat, double solarDec) {
     return HA * 180.0 / M_PI;
 }
 
+// Hour angle magnitude at which a body first rises above (rising) or last
+// sinks below (setting) the horizon profile, given the flat-horizon zenith
+// distance that folds in refraction and semi-diameter.
+//
+// Declination is constant over the day in this model, so altitude is
+// monotonic in |hour angle| and the event must lie between the analytic
+// crossings of the profile's lowest and highest elevations. That window is
+// scanned at the profile's azimuth resolution and the first sign change is
+// refined by bisection, instead of sampling the whole day.
+double AstronomyCalculator::calcHourAngleHorizon(double lat, double dec, double zenith, bool rising) {
+    double latRad = lat * M_PI / 180.0;
+    double decRad = dec * M_PI / 180.0;
+    double sinLatSinDec = sin(latRad) * sin(decRad);
+    double cosLatCosDec = cos(latRad) * cos(decRad);
+    if (fabs(cosLatCosDec) < 1e-12) return -999; // Altitude never changes
+    
+    double dip = 90.0 - zenith;
+    double lowest = horizon->minElevation() + dip;
+    double highest = horizon->maxElevation() + dip;
+    
+    // Altitude at hour angle s (degrees); lowest at s = 180, highest at 0
+    auto altitude = [&](double s) {
+        return asin(std::max(-1.0, std::min(1.0, sinLatSinDec + cosLatCosDec * cos(s * M_PI / 180.0)))) * 180.0 / M_PI;
+    };
+    // Hour angle at which the altitude equals h
+    auto crossing = [&](double h) {
+        double arg = (sin(h * M_PI / 180.0) - sinLatSinDec) / cosLatCosDec;
+        return acos(std::max(-1.0, std::min(1.0, arg))) * 180.0 / M_PI;
+    };
+    // Altitude above the local horizon; hour angle is negative while rising
+    auto clearance = [&](double s) {
+        double ha = (rising ? -s : s) * M_PI / 180.0;
+        double azimuth = atan2(sin(ha), cos(ha) * sin(latRad) - tan(decRad) * cos(latRad)) * 180.0 / M_PI + 180.0;
+        return altitude(s) - (horizon->elevationAt(azimuth) + dip);
+    };
+    
+    if (altitude(0.0) <= lowest || altitude(180.0) > highest) {
+        return -999; // Never clears the horizon, or never drops behind it
+    }
+    
+    double start = (altitude(180.0) >= lowest) ? 180.0 : crossing(lowest);
+    double end = (altitude(0.0) <= highest) ? 0.0 : crossing(highest);
+    
+    // One step per profile bin, at most a degree
+    double step = std::min(1.0, 360.0 / horizon->binCount());
+    int steps = std::max(1, (int)ceil((start - end) / step));
+    
+    // Window ends found analytically are hidden/visible by construction;
+    // don't let rounding at the exact crossing decide them
+    double previous = start;
+    bool hidden = (start < 180.0) || clearance(start) <= 0.0;
+    for (int i = 1; i <= steps; i++) {
+        double s = start - (start - end) * i / steps;
+        bool visible = (i == steps && end > 0.0) || clearance(s) > 0.0;
+        if (hidden && visible) {
+            double hiddenAt = previous, visibleAt = s;
+            while (hiddenAt - visibleAt > 1e-5) {
+                double middle = (hiddenAt + visibleAt) / 2.0;
+                if (clearance(middle) > 0.0) visibleAt = middle;
+                else hiddenAt = middle;
+            }
+            return visibleAt;
+        }
+        hidden = !visible;
+        previous = s;
+    }
+    
+    return -999; // Visible throughout this half of the day
+}
+
 // Calculate sunrise time
 double AstronomyCalculator::calcSunrise(double jd, double latitude, double longitude) {
     double solarDec = calcSunDeclination(jd);
-    double hourAngle = calcHourAngleSunrise(latitude, solarDec);
+    double hourAngle = horizon ? calcHourAngleHorizon(latitude, solarDec, 90.833, true)
+                               : calcHourAngleSunrise(latitude, solarDec);
     
     if (hourAngle <= -999) return -1;
     
@@ -186,7 +361,8 @@ double AstronomyCalculator::calcSunrise(double jd, double latitude, double longi
 // Calculate sunset time
 double AstronomyCalculator::calcSunset(double jd, double latitude, double longitude) {
     double solarDec = calcSunDeclination(jd);
-    double hourAngle = calcHourAngleSunrise(latitude, solarDec);
+    double hourAngle = horizon ? calcHourAngleHorizon(latitude, solarDec, 90.833, false)
+                               : calcHourAngleSunrise(latitude, solarDec);
     
     if (hourAngle <= -999) return -1;
     
@@ -254,7 +430,7 @@ double AstronomyCalculator::calcMoonPosition(double jd, double* moonRA, double*
     return longitude;
 }
 
-// Calculate moon phase angle
+// Calculate the astronomical phase angle (sun-moon-earth): 0 = full, 180 = new
 double AstronomyCalculator::calcMoonPhaseAngle(double jd) {
     double n = jd - 2451545.0;
     double L = fmod(218.316 + 13.176396 * n, 360.0);
@@ -272,17 +448,23 @@ double AstronomyCalculator::calcMoonrise(double jd, double latitude, double long
     double moonRA, moonDec;
     calcMoonPosition(jd, &moonRA, &moonDec);
     
-    // Use same method as sun but with moon's position
-    double latRad = latitude * M_PI / 180.0;
-    double decRad = moonDec * M_PI / 180.0;
-    
-    double HAarg = (cos(90.567 * M_PI / 180.0) / (cos(latRad) * cos(decRad))) - tan(latRad) * tan(decRad);
-    
-    if (HAarg < -1.0 || HAarg > 1.0) {
-        return -1; // No moonrise
+    double HA;
+    if (horizon) {
+        HA = calcHourAngleHorizon(latitude, moonDec, 90.567, true);
+        if (HA <= -999) return -1; // No moonrise
+    } else {
+        // Use same method as sun but with moon's position
+        double latRad = latitude * M_PI / 180.0;
+        double decRad = moonDec * M_PI / 180.0;
+        
+        double HAarg = (cos(90.567 * M_PI / 180.0) / (cos(latRad) * cos(decRad))) - tan(latRad) * tan(decRad);
+        
+        if (HAarg < -1.0 || HAarg > 1.0) {
+            return -1; // No moonrise
+        }
+        
+        HA = acos(HAarg) * 180.0 / M_PI;
     }
-    
-    double HA = acos(HAarg) * 180.0 / M_PI;
     double riseTime = (moonRA - HA) / 15.0 + longitude / 15.0;
     
     return fmod(riseTime + 24.0, 24.0);
@@ -293,17 +475,23 @@ double AstronomyCalculator::calcMoonset(double jd, double latitude, double longi
     double moonRA, moonDec;
     calcMoonPosition(jd, &moonRA, &moonDec);
     
-    // Use same method as sun but with moon's position
-    double latRad = latitude * M_PI / 180.0;
-    double decRad = moonDec * M_PI / 180.0;
-    
-    double HAarg = (cos(90.567 * M_PI / 180.0) / (cos(latRad) * cos(decRad))) - tan(latRad) * tan(decRad);
-    
-    if (HAarg < -1.0 || HAarg > 1.0) {
-        return -1; // No moonset
+    double HA;
+    if (horizon) {
+        HA = calcHourAngleHorizon(latitude, moonDec, 90.567, false);
+        if (HA <= -999) return -1; // No moonset
+    } else {
+        // Use same method as sun but with moon's position
+        double latRad = latitude * M_PI / 180.0;
+        double decRad = moonDec * M_PI / 180.0;
+        
+        double HAarg = (cos(90.567 * M_PI / 180.0) / (cos(latRad) * cos(decRad))) - tan(latRad) * tan(decRad);
+        
+        if (HAarg < -1.0 || HAarg > 1.0) {
+            return -1; // No moonset
+        }
+        
+        HA = acos(HAarg) * 180.0 / M_PI;
     }
-    
-    double HA = acos(HAarg) * 180.0 / M_PI;
     double setTime = (moonRA + HA) / 15.0 + longitude / 15.0;
     
     return fmod(setTime + 24.0, 24.0);
@@ -330,20 +518,44 @@ double AstronomyCalculator::calcMoonAzEl(double jd, double hour, double lat, dou
     return elevation;
 }
 
-// Check if moon is currently visible
-bool AstronomyCalculator::isMoonCurrentlyVisible() {
-    double moonRA, moonDec;
-    calcMoonPosition(julianDay, &moonRA, &moonDec);
-    
+// Calculate sun altitude and azimuth at any instant
+double AstronomyCalculator::sunAltitudeAt(time_t unixTime, double* azimuth) {
+    double hour = toLocalHour(unixTime);
+    return calcSunAzEl(toJulianDay(unixTime), hour, latitude, longitude, azimuth);
+}
+
+// Calculate moon altitude and azimuth at any instant
+double AstronomyCalculator::moonAltitudeAt(time_t unixTime, double* azimuth) {
+    double hour = toLocalHour(unixTime);
+    return calcMoonAzEl(toJulianDay(unixTime), hour, latitude, longitude, azimuth);
+}
+
+// Check if moon is visible at an instant; against the profile, with the
+// same dip as moonrise/moonset, when one is given
+bool AstronomyCalculator::isMoonCurrentlyVisible(double jd, double hour, double lat, double lng,
+                                                 const HorizonProfile* horizon) {
     double moonAz;
-    double moonAlt = calcMoonAzEl(julianDay, localHour, latitude, longitude, &moonAz);
+    double moonAlt = calcMoonAzEl(jd, hour, lat, lng, &moonAz);
     
+    if (horizon) {
+        return moonAlt > horizon->elevationAt(moonAz) + (90.0 - 90.567);
+    }
     return moonAlt > 0.0; // Above horizon
 }
 
 // Format time as HHMM string
 std::string AstronomyCalculator::formatTime(double hour) {
-    if (hour < 0) return "";
+    char buffer[5];
+    formatClock(hour, buffer);
+    return std::string(buffer);
+}
+
+// Format time as HHMM into a 5-byte buffer; "" for a negative hour
+void AstronomyCalculator::formatClock(double hour, char* buffer) {
+    if (hour < 0) {
+        buffer[0] = '\0';
+        return;
+    }
     
     int h = (int)hour;
     int m = (int)((hour - h) * 60.0);
@@ -355,9 +567,12 @@ std::string AstronomyCalculator::formatTime(double hour) {
     }
     if (h >= 24) h -= 24;
     
-    char buffer[6];
-    snprintf(buffer, sizeof(buffer), "%02d%02d", h, m);
-    return std::string(buffer);
+    // Digits written directly; snprintf costs more than the rest of a cache hit
+    buffer[0] = (char)('0' + h / 10);
+    buffer[1] = (char)('0' + h % 10);
+    buffer[2] = (char)('0' + m / 10);
+    buffer[3] = (char)('0' + m % 10);
+    buffer[4] = '\0';
 }
 
 // Convert hours to minutes
@@ -374,14 +589,49 @@ double AstronomyCalculator::normalizeAngle(double angle) {
 
 // Get moon phase description
 std::string AstronomyCalculator::moonPhase() {
-    double phaseAngle = calcMoonPhaseAngle(julianDay);
-    
-    if (phaseAngle < 22.5 || phaseAngle >= 337.5) return "New Moon";
-    else if (phaseAngle < 67.5) return "Waxing Crescent";
-    else if (phaseAngle < 112.5) return "First Quarter";
-    else if (phaseAngle < 157.5) return "Waxing Gibbous";
-    else if (phaseAngle < 202.5) return "Full Moon";
-    else if (phaseAngle < 247.5) return "Waning Gibbous";
-    else if (phaseAngle < 292.5) return "Last Quarter";
-    else return "Waning Crescent";
+    return moonPhaseName(moonPhaseIndex());
+}
+
+// Get moon phase as one of eight 45 degree sectors
+int AstronomyCalculator::moonPhaseIndex() const {
+    return moonPhaseIndexAt(julianDay);
+}
+
+// Phase sector at Julian day jd, as moonPhaseIndex()
+int AstronomyCalculator::moonPhaseIndexAt(double jd) {
+    double phaseAngle = normalizeAngle(180.0 - calcMoonPhaseAngle(jd));
+    
+    if (phaseAngle < 22.5 || phaseAngle >= 337.5) return 0;
+    else if (phaseAngle < 67.5) return 1;
+    else if (phaseAngle < 112.5) return 2;
+    else if (phaseAngle < 157.5) return 3;
+    else if (phaseAngle < 202.5) return 4;
+    else if (phaseAngle < 247.5) return 5;
+    else if (phaseAngle < 292.5) return 6;
+    else return 7;
+}
+
+// Get continuous moon phase angle in degrees; this is the elongation-based
+// supplement of the astronomical phase angle, so 0 = new and 180 = full
+double AstronomyCalculator::moonPhaseAngle() const {
+    return normalizeAngle(180.0 - calcMoonPhaseAngle(julianDay));
+}
+
+// Get illuminated fraction of the moon's disk
+double AstronomyCalculator::moonIlluminatedFraction() const {
+    return (1.0 - cos(moonPhaseAngle() * M_PI / 180.0)) / 2.0;
+}
+
+// Check whether the illuminated fraction is growing
+bool AstronomyCalculator::isMoonWaxing() const {
+    return moonPhaseAngle() < 180.0;
+}
+
+// Get moon phase name for a phase index
+const char* AstronomyCalculator::moonPhaseName(int index) {
+    static const char* const names[] = {
+        "New Moon", "Waxing Crescent", "First Quarter", "Waxing Gibbous",
+        "Full Moon", "Waning Gibbous", "Last Quarter", "Waning Crescent"
+    };
+    return (index >= 0 && index < 8) ? names[index] : "";
 }
\ No newline at end of file
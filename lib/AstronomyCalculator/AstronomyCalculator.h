@@ -6,6 +6,19 @@
 #include <string>
 #include <algorithm>
 
+class HorizonProfile;
+struct AstronomyRecord;
+
+// Rise/set solutions for one date, in local hours (-1 when there is none),
+// solved at the date's local noon. These are the expensive part of a
+// calculation; everything else follows cheaply from them and the time of day.
+struct AstronomyDayEvents {
+    double sunrise;
+    double sunset;
+    double moonrise[3]; // yesterday, today, tomorrow
+    double moonset[3];
+};
+
 class AstronomyCalculator {
 private:
     // Input parameters
@@ -16,33 +29,54 @@ private:
     // Common calculations
     double julianDay;
     double localHour;
+    const HorizonProfile* horizon; // only used during construction
+    AstronomyDayEvents events;
     
     // Internal calculation methods
-    double toJulianDay(time_t unixTime);
-    double calcSunDeclination(double julianDay);
-    double calcSunEquationOfTime(double julianDay);
+    static double toJulianDay(time_t unixTime);
+    static double toLocalHour(time_t unixTime);
+    static int toLocalSecondOfDay(time_t unixTime);
+    static double calcSunDeclination(double julianDay);
+    static double calcSunEquationOfTime(double julianDay);
     double calcHourAngleSunrise(double lat, double solarDec);
+    double calcHourAngleHorizon(double lat, double dec, double zenith, bool rising);
     double calcSunrise(double julianDay, double latitude, double longitude);
     double calcSunset(double julianDay, double latitude, double longitude);
-    double calcSunAzEl(double julianDay, double hour, double lat, double lng, double* azimuth);
+    static double calcSunAzEl(double julianDay, double hour, double lat, double lng, double* azimuth);
     
     // Moon calculation methods
-    double calcMoonPosition(double julianDay, double* moonRA, double* moonDec);
-    double calcMoonPhaseAngle(double julianDay);
+    static double calcMoonPosition(double julianDay, double* moonRA, double* moonDec);
+    static double calcMoonPhaseAngle(double julianDay);
     double calcMoonrise(double julianDay, double latitude, double longitude);
     double calcMoonset(double julianDay, double latitude, double longitude);
-    double calcMoonAzEl(double julianDay, double hour, double lat, double lng, double* azimuth);
+    static double calcMoonAzEl(double julianDay, double hour, double lat, double lng, double* azimuth);
     
     // Utility methods
     std::string formatTime(double hour);
+    static void formatClock(double hour, char* buffer);
     std::string formatTimeFromMinutes(int minutes);
-    int hoursToMinutes(double hours);
-    double normalizeAngle(double angle);
-    bool isMoonCurrentlyVisible();
+    static int hoursToMinutes(double hours);
+    static double normalizeAngle(double angle);
+    static int moonPhaseIndexAt(double julianDay);
+    static bool isMoonCurrentlyVisible(double julianDay, double hour, double lat, double lng,
+                                       const HorizonProfile* horizon);
+    static void deriveRecord(double lat, double lng, double julianDay, double hour,
+                             const AstronomyDayEvents& events, const HorizonProfile* horizon,
+                             AstronomyRecord* record);
+    void calculateFromEvents();
 
 public:
-    // Constructor
+    // Constructors - flat horizon, or rise/set against a site horizon profile
     AstronomyCalculator(double lat, double lng, time_t unixTime);
+    AstronomyCalculator(double lat, double lng, time_t unixTime, const HorizonProfile* horizon);
+    
+    // Constructor - reuses rise/set solutions from dayEvents() of an earlier calculation
+    AstronomyCalculator(double lat, double lng, time_t unixTime, const AstronomyDayEvents& dayEvents);
+    
+    // Same results as AstronomyRecord(AstronomyCalculator(lat, lng, unixTime, dayEvents)),
+    // derived without building a calculator or any std::string
+    static AstronomyRecord recordFromEvents(double lat, double lng, time_t unixTime,
+                                            const AstronomyDayEvents& dayEvents);
     
     // Public member variables - calculated on construction
     bool isMoonVisible;
@@ -73,6 +107,15 @@ public:
     
     // Public methods
     std::string moonPhase();
+    int moonPhaseIndex() const; // 0 = New Moon ... 7 = Waning Crescent
+    static const char* moonPhaseName(int index);
+    double moonPhaseAngle() const; // degrees, 0 = new, 180 = full, as used by moonPhase()
+    double sunAltitudeAt(time_t unixTime, double* azimuth);  // same model as sunAltitudeAtRise
+    double moonAltitudeAt(time_t unixTime, double* azimuth); // same model as isMoonVisible
+    double moonIlluminatedFraction() const; // 0.0 (new) to 1.0 (full)
+    bool isMoonWaxing() const;
+    const AstronomyDayEvents& dayEvents() const { return events; }
+    static time_t localNoon(time_t unixTime); // instant a date's rise/set are solved at
 };
 
 #endif
\ No newline at end of file
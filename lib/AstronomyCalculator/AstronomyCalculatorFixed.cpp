@@ -0,0 +1,575 @@
+#include "AstronomyCalculatorFixed.h"
+#include "AstronomyCalculator.h"
+#include <cstdio>
+
+namespace {
+
+// Times of day share the angle format: 2^32 == 24 hours
+const int64_t DAY = 1LL << 32;
+const int64_t HALF_DAY = 1LL << 31;
+
+// Sentinels mirroring the -1 hour / -999 hour values of AstronomyCalculator
+const int64_t NO_EVENT = -(DAY / 24);
+const int64_t NEVER = INT64_MIN;
+
+// J2000.0 (JD 2451545.0) as a Unix timestamp
+const int64_t J2000_UNIX = 946728000;
+
+// Compile-time degree -> BAM conversion for constants
+constexpr uint32_t deg(double degrees) {
+    return (uint32_t)(int64_t)(degrees / 360.0 * 4294967296.0 + (degrees >= 0 ? 0.5 : -0.5));
+}
+
+// Compile-time degrees/day -> BAM/second in Q16
+constexpr uint64_t rate(double degreesPerDay) {
+    return (uint64_t)(degreesPerDay / 360.0 * 4294967296.0 / 86400.0 * 65536.0 + 0.5);
+}
+
+// Q30 constants (see AstronomyCalculator.cpp for the double originals)
+const int32_t SIN_EPSILON = 427104964;     // sin(23.439)
+const int32_t COS_EPSILON = 985141033;     // cos(23.439)
+const int32_t COS_SUN_ZENITH = -15610145;  // cos(90.833)
+const int32_t COS_MOON_ZENITH = -10625594; // cos(90.567)
+const int32_t TAN2_HALF_EPSILON = 46206794; // tan(23.439 / 2)^2
+const int32_t ECCENTRICITY_J2000 = 17940759; // 0.016708634
+const int64_t ECCENTRICITY_RATE = 8765;      // 4.2037e-8 per day, Q30 per second << 24
+const int32_t RADIANS_Q30_TO_BAM = 683565276; // 2^32 / (2 * pi), in Q30
+
+// Series terms as BAM angles and Q16 rates. constexpr so the deg()/rate()
+// double math never runs on the target, even in unoptimized builds.
+constexpr uint32_t SUN_MEAN_LONGITUDE = deg(280.460);
+constexpr uint64_t SUN_MEAN_LONGITUDE_RATE = rate(0.9856474);
+constexpr uint32_t SUN_MEAN_ANOMALY = deg(357.528);
+constexpr uint64_t SUN_MEAN_ANOMALY_RATE = rate(0.9856003);
+constexpr int32_t SUN_CENTRE_1 = (int32_t)deg(1.915);
+constexpr int32_t SUN_CENTRE_2 = (int32_t)deg(0.020);
+
+constexpr uint32_t MOON_MEAN_LONGITUDE = deg(218.316);
+constexpr uint64_t MOON_MEAN_LONGITUDE_RATE = rate(13.176396);
+constexpr uint32_t MOON_MEAN_ANOMALY = deg(134.963);
+constexpr uint64_t MOON_MEAN_ANOMALY_RATE = rate(13.064993);
+constexpr uint32_t MOON_ARGUMENT_OF_LATITUDE = deg(93.272);
+constexpr uint64_t MOON_ARGUMENT_OF_LATITUDE_RATE = rate(13.229350);
+constexpr int32_t MOON_CENTRE = (int32_t)deg(6.289);
+constexpr int32_t MOON_LATITUDE_AMPLITUDE = (int32_t)deg(5.128);
+
+constexpr uint32_t PHASE_SUN_ANOMALY = deg(357.529);
+constexpr uint64_t PHASE_SUN_ANOMALY_RATE = rate(0.98560028);
+constexpr uint32_t PHASE_ELONGATION = deg(297.850);
+constexpr uint64_t PHASE_ELONGATION_RATE = rate(12.190749);
+constexpr int32_t PHASE_SUN_TERM = (int32_t)deg(2.1);
+constexpr uint32_t PHASE_HALF_SECTOR = deg(22.5);
+
+// CORDIC tables: atan(2^-i) in BAM and the inverse gain in Q30. 24
+// iterations leave a residual angle below 1e-5 degrees, far under the
+// precision the algorithms themselves carry.
+const int CORDIC_ITERATIONS = 24;
+const int32_t CORDIC_ATAN[CORDIC_ITERATIONS] = {
+    536870912, 316933406, 167458907, 85004756, 42667331, 21354465,
+    10679838, 5340245, 2670163, 1335087, 667544, 333772, 166886, 83443,
+    41722, 20861, 10430, 5215, 2608, 1304, 652, 326, 163, 81
+};
+const int32_t CORDIC_INV_GAIN = 652032874;
+
+// Angle advanced linearly from J2000 at a fixed rate; wraps mod 360
+uint32_t meanAngle(uint32_t atJ2000, uint64_t rateQ16, int64_t seconds) {
+    return atJ2000 + (uint32_t)(((uint64_t)seconds * rateQ16) >> 16);
+}
+
+// Integer square root of a 64-bit value
+uint32_t isqrt64(uint64_t value) {
+    uint64_t result = 0;
+    uint64_t bit = 1ULL << 62;
+    while (bit > value) bit >>= 2;
+    while (bit != 0) {
+        if (value >= result + bit) {
+            value -= result + bit;
+            result = (result >> 1) + bit;
+        } else {
+            result >>= 1;
+        }
+        bit >>= 2;
+    }
+    return (uint32_t)result;
+}
+
+int32_t clampQ30(int64_t value) {
+    if (value > AstronomyCalculatorFixed::Q30_ONE) return AstronomyCalculatorFixed::Q30_ONE;
+    if (value < -AstronomyCalculatorFixed::Q30_ONE) return -AstronomyCalculatorFixed::Q30_ONE;
+    return (int32_t)value;
+}
+
+}
+
+// Constructor - performs all calculations
+AstronomyCalculatorFixed::AstronomyCalculatorFixed(double lat, double lng, time_t unixTime)
+    : AstronomyCalculatorFixed(degreesToAngle(lat), degreesToAngle(lng), unixTime, true) {
+}
+
+// Constructor for callers that keep coordinates as integer micro-degrees
+AstronomyCalculatorFixed AstronomyCalculatorFixed::fromMicroDegrees(int32_t latMicroDeg, int32_t lngMicroDeg, time_t unixTime) {
+    return AstronomyCalculatorFixed(microDegreesToAngle(latMicroDeg), microDegreesToAngle(lngMicroDeg), unixTime, true);
+}
+
+AstronomyCalculatorFixed::AstronomyCalculatorFixed(int32_t latAngle, int32_t lngAngle, time_t unixTime, bool)
+    : latitude(latAngle), longitude(lngAngle), timestamp(unixTime) {
+
+    sinCos((uint32_t)latitude, &sinLatitude, &cosLatitude);
+    secondsSinceJ2000 = (int64_t)unixTime - J2000_UNIX;
+
+    // Convert timestamp to local time of day (same fallback as AstronomyCalculator)
+    struct tm timeinfo;
+    uint32_t secondOfDay;
+    if (localtime_r(&unixTime, &timeinfo) != nullptr) {
+        secondOfDay = timeinfo.tm_hour * 3600 + timeinfo.tm_min * 60 + timeinfo.tm_sec;
+    } else {
+        secondOfDay = (uint32_t)((((int64_t)unixTime % 86400) + 86400) % 86400);
+    }
+    int64_t local = (int64_t)(((uint64_t)secondOfDay << 32) / 86400);
+    localTime = (uint32_t)local;
+
+    // Rise/set are solved at local noon, as in AstronomyCalculator
+    int64_t noon = secondsSinceJ2000 - secondOfDay + 12 * 3600;
+
+    // Calculate sun data
+    int64_t sunriseTime = calcSunrise(noon);
+    int64_t sunsetTime = calcSunset(noon);
+
+    sunRiseTodayHHMM = formatTime(sunriseTime);
+    sunSetTodayHHMM = formatTime(sunsetTime);
+
+    // Calculate sun timing relative to current time
+    int64_t sinceSunrise = local - sunriseTime;
+    int64_t sinceSunset = local - sunsetTime;
+    int64_t untilSunset = sunsetTime - local;
+    int64_t untilSunrise = (sunriseTime + DAY) - local; // Next day
+
+    minutesSinceSunRise = (sinceSunrise >= 0) ? dayTimeToMinutes(sinceSunrise) : -1;
+    minutesSinceSunSet = (sinceSunset >= 0) ? dayTimeToMinutes(sinceSunset) : -1;
+    minutesUntilSunSet = (untilSunset >= 0 && sinceSunset < 0) ? dayTimeToMinutes(untilSunset) : -1;
+    minutesUntilSunRise = (local > sunriseTime && local > sunsetTime) ? dayTimeToMinutes(untilSunrise) : -1;
+
+    minutesSunVisible = (sunsetTime > sunriseTime) ? dayTimeToMinutes(sunsetTime - sunriseTime) : 0;
+
+    // Calculate sun position at rise
+    uint32_t azimuth;
+    sunAltitudeAtRise = angleToDegrees(calcSunAzEl(secondsSinceJ2000, sunriseTime, &azimuth));
+    sunAzimuthAtRise = bearingToDegrees(azimuth);
+
+    // Calculate moon data
+    int64_t moonriseToday = calcMoonrise(noon);
+    int64_t moonsetToday = calcMoonset(noon);
+    int64_t moonriseYesterday = calcMoonrise(noon - 86400);
+    int64_t moonsetYesterday = calcMoonset(noon - 86400);
+    int64_t moonriseTomorrow = calcMoonrise(noon + 86400);
+    int64_t moonsetTomorrow = calcMoonset(noon + 86400);
+
+    // Determine current moon visibility
+    isMoonVisible = calcMoonAzEl(secondsSinceJ2000, local, &azimuth) > 0;
+
+    // Find most recent moonrise/moonset
+    int64_t lastMoonRise = NEVER, lastMoonSet = NEVER;
+    if (moonriseToday >= 0 && moonriseToday <= local) {
+        lastMoonRise = moonriseToday;
+    } else if (moonriseYesterday >= 0) {
+        lastMoonRise = moonriseYesterday;
+    }
+
+    if (moonsetToday >= 0 && moonsetToday <= local) {
+        lastMoonSet = moonsetToday;
+    } else if (moonsetYesterday >= 0) {
+        lastMoonSet = moonsetYesterday;
+    }
+
+    // Find next moonrise/moonset
+    int64_t nextMoonRise = NEVER, nextMoonSet = NEVER;
+    if (moonriseToday >= 0 && moonriseToday > local) {
+        nextMoonRise = moonriseToday;
+    } else if (moonriseTomorrow >= 0) {
+        nextMoonRise = moonriseTomorrow;
+    }
+
+    if (moonsetToday >= 0 && moonsetToday > local) {
+        nextMoonSet = moonsetToday;
+    } else if (moonsetTomorrow >= 0) {
+        nextMoonSet = moonsetTomorrow;
+    }
+
+    // Convert to member variables
+    minutesSinceLastMoonRise = (lastMoonRise != NEVER) ? dayTimeToMinutes(local - lastMoonRise + ((lastMoonRise > local) ? DAY : 0)) : -1;
+    minutesSinceLastMoonSet = (lastMoonSet != NEVER) ? dayTimeToMinutes(local - lastMoonSet + ((lastMoonSet > local) ? DAY : 0)) : -1;
+    minutesUntilNextMoonRise = (nextMoonRise != NEVER) ? dayTimeToMinutes(nextMoonRise - local + ((nextMoonRise < local) ? DAY : 0)) : -1;
+    minutesUntilNextMoonSet = (nextMoonSet != NEVER) ? dayTimeToMinutes(nextMoonSet - local + ((nextMoonSet < local) ? DAY : 0)) : -1;
+
+    // Format time strings with conditional logic
+    nextMoonRiseHHMM = (isMoonVisible || nextMoonRise == NEVER) ? "" : formatTime(nextMoonRise);
+    nextMoonSetHHMM = (nextMoonSet == NEVER) ? "" : formatTime(nextMoonSet);
+    lastMoonRiseHHMM = (lastMoonRise == NEVER) ? "" : formatTime(lastMoonRise);
+    lastMoonSetHHMM = (lastMoonSet == NEVER) ? "" : formatTime(lastMoonSet);
+
+    // Calculate moon visibility duration
+    if (lastMoonRise != NEVER && nextMoonSet != NEVER) {
+        int64_t visibleDuration = nextMoonSet - lastMoonRise;
+        if (visibleDuration < 0) visibleDuration += DAY;
+        minutesMoonVisible = dayTimeToMinutes(visibleDuration);
+    } else {
+        minutesMoonVisible = 0;
+    }
+
+    // Calculate moon position at rise
+    int64_t moonRise = (nextMoonRise != NEVER) ? nextMoonRise : lastMoonRise;
+    if (moonRise != NEVER) {
+        moonAltitudeAtRise = angleToDegrees(calcMoonAzEl(secondsSinceJ2000, moonRise, &azimuth));
+        moonAzimuthAtRise = bearingToDegrees(azimuth);
+    } else {
+        moonAltitudeAtRise = moonAzimuthAtRise = -1;
+    }
+}
+
+// Q30 multiply
+int32_t AstronomyCalculatorFixed::mulQ30(int32_t a, int32_t b) {
+    return (int32_t)(((int64_t)a * b) >> 30);
+}
+
+// CORDIC rotation mode: sine and cosine of a BAM angle in Q30
+void AstronomyCalculatorFixed::sinCos(uint32_t angle, int32_t* sinOut, int32_t* cosOut) {
+    // Fold into [-90, 90] degrees; the other half-circle is the negation
+    int32_t z = (int32_t)angle;
+    bool negate = false;
+    if (z > (1 << 30) || z < -(1 << 30)) {
+        z = (int32_t)(angle - 0x80000000u);
+        negate = true;
+    }
+
+    int32_t x = CORDIC_INV_GAIN;
+    int32_t y = 0;
+    for (int i = 0; i < CORDIC_ITERATIONS; i++) {
+        int32_t dx = y >> i;
+        int32_t dy = x >> i;
+        if (z >= 0) {
+            x -= dx;
+            y += dy;
+            z -= CORDIC_ATAN[i];
+        } else {
+            x += dx;
+            y -= dy;
+            z += CORDIC_ATAN[i];
+        }
+    }
+
+    *sinOut = negate ? -y : y;
+    *cosOut = negate ? -x : x;
+}
+
+// CORDIC vectoring mode: angle of the vector (x, y) in BAM
+uint32_t AstronomyCalculatorFixed::atan2(int32_t y, int32_t x) {
+    if (x == 0 && y == 0) return 0;
+
+    // Rotate into the right half-plane
+    int64_t vx = x, vy = y;
+    uint32_t angle = 0;
+    if (vx < 0) {
+        vx = -vx;
+        vy = -vy;
+        angle = 0x80000000u;
+    }
+
+    // Normalize so the CORDIC gain (~1.65) cannot overflow 32 bits
+    int64_t magnitude = (vx > (vy < 0 ? -vy : vy)) ? vx : (vy < 0 ? -vy : vy);
+    while (magnitude >= (1LL << 29)) {
+        vx >>= 1;
+        vy >>= 1;
+        magnitude >>= 1;
+    }
+    while (magnitude < (1LL << 28)) {
+        vx *= 2;
+        vy *= 2;
+        magnitude *= 2;
+    }
+
+    int32_t cx = (int32_t)vx, cy = (int32_t)vy;
+    int32_t z = 0;
+    for (int i = 0; i < CORDIC_ITERATIONS; i++) {
+        int32_t dx = cy >> i;
+        int32_t dy = cx >> i;
+        if (cy > 0) {
+            cx += dx;
+            cy -= dy;
+            z += CORDIC_ATAN[i];
+        } else {
+            cx -= dx;
+            cy += dy;
+            z -= CORDIC_ATAN[i];
+        }
+    }
+
+    return angle + (uint32_t)z;
+}
+
+// Arcsine of a Q30 value, as a signed BAM angle in [-90, 90]
+int32_t AstronomyCalculatorFixed::asin(int32_t value) {
+    value = clampQ30(value);
+    uint32_t c = isqrt64((uint64_t)((int64_t)Q30_ONE - value) * (uint64_t)((int64_t)Q30_ONE + value));
+    return (int32_t)atan2(value, (int32_t)c);
+}
+
+// Arccosine of a Q30 value, as a BAM angle in [0, 180]
+uint32_t AstronomyCalculatorFixed::acos(int32_t value) {
+    value = clampQ30(value);
+    uint32_t s = isqrt64((uint64_t)((int64_t)Q30_ONE - value) * (uint64_t)((int64_t)Q30_ONE + value));
+    return atan2((int32_t)s, value);
+}
+
+// Convert degrees to a signed BAM angle
+int32_t AstronomyCalculatorFixed::degreesToAngle(double degrees) {
+    return (int32_t)(uint32_t)(int64_t)(degrees * (4294967296.0 / 360.0) + (degrees >= 0 ? 0.5 : -0.5));
+}
+
+// Convert micro-degrees to a signed BAM angle without floating point
+int32_t AstronomyCalculatorFixed::microDegreesToAngle(int32_t microDegrees) {
+    // 2^32 / 360e6 in Q28
+    return (int32_t)(((int64_t)microDegrees * 3202559735LL + (1LL << 27)) >> 28);
+}
+
+// Convert a signed BAM angle to degrees in [-180, 180)
+double AstronomyCalculatorFixed::angleToDegrees(int32_t angle) {
+    return angle * (360.0 / 4294967296.0);
+}
+
+// Convert an unsigned BAM angle to degrees in [0, 360)
+double AstronomyCalculatorFixed::bearingToDegrees(uint32_t angle) {
+    return angle * (360.0 / 4294967296.0);
+}
+
+// Solar declination (NOAA algorithm) and equation of time
+void AstronomyCalculatorFixed::calcSunPosition(int64_t seconds, int32_t* declination, int32_t* eqTime) {
+    uint32_t L = meanAngle(SUN_MEAN_LONGITUDE, SUN_MEAN_LONGITUDE_RATE, seconds);
+    uint32_t g = meanAngle(SUN_MEAN_ANOMALY, SUN_MEAN_ANOMALY_RATE, seconds);
+
+    int32_t sinG, cosG, sin2G, cos2G;
+    sinCos(g, &sinG, &cosG);
+    sinCos(g << 1, &sin2G, &cos2G);
+
+    uint32_t lambda = L + mulQ30(SUN_CENTRE_1, sinG) + mulQ30(SUN_CENTRE_2, sin2G);
+    int32_t sinLambda, cosLambda;
+    sinCos(lambda, &sinLambda, &cosLambda);
+    *declination = asin(mulQ30(SIN_EPSILON, sinLambda));
+
+    // Equation of time in radians (Q30), then as a time of day
+    int32_t y = TAN2_HALF_EPSILON;
+    int32_t e = ECCENTRICITY_J2000 - (int32_t)((seconds * ECCENTRICITY_RATE) >> 24);
+    int32_t sin2L, cos2L, sin4L, cos4L;
+    sinCos(L << 1, &sin2L, &cos2L);
+    sinCos(L << 2, &sin4L, &cos4L);
+
+    int32_t E = mulQ30(y, sin2L)
+              - 2 * mulQ30(e, sinG)
+              + 4 * mulQ30(mulQ30(e, y), mulQ30(sinG, cos2L))
+              - mulQ30(mulQ30(y, y), sin4L) / 2
+              - mulQ30(mulQ30(e, e), sin2G) * 5 / 4;
+
+    *eqTime = mulQ30(E, RADIANS_Q30_TO_BAM);
+}
+
+// Hour angle at which a body of the given declination crosses the zenith
+// distance whose cosine is cosZenith; valid is false if it never does
+uint32_t AstronomyCalculatorFixed::calcHourAngle(int32_t cosZenith, int32_t dec, bool* valid) {
+    int32_t sinDec, cosDec;
+    sinCos((uint32_t)dec, &sinDec, &cosDec);
+
+    int64_t num = (int64_t)cosZenith - mulQ30(sinLatitude, sinDec);
+    int64_t den = mulQ30(cosLatitude, cosDec);
+
+    if (den <= 0 || num > den || num < -den) {
+        *valid = false; // No rise/set
+        return 0;
+    }
+
+    *valid = true;
+    return acos((int32_t)(num * Q30_ONE / den));
+}
+
+// Calculate sunrise time
+int64_t AstronomyCalculatorFixed::calcSunrise(int64_t seconds) {
+    int32_t solarDec, eqTime;
+    calcSunPosition(seconds, &solarDec, &eqTime);
+
+    bool valid;
+    uint32_t hourAngle = calcHourAngle(COS_SUN_ZENITH, solarDec, &valid);
+    if (!valid) return NO_EVENT;
+
+    // Longitude cancels out as in the double implementation
+    return (uint32_t)(0x80000000u - hourAngle + (uint32_t)eqTime);
+}
+
+// Calculate sunset time
+int64_t AstronomyCalculatorFixed::calcSunset(int64_t seconds) {
+    int32_t solarDec, eqTime;
+    calcSunPosition(seconds, &solarDec, &eqTime);
+
+    bool valid;
+    uint32_t hourAngle = calcHourAngle(COS_SUN_ZENITH, solarDec, &valid);
+    if (!valid) return NO_EVENT;
+
+    return (uint32_t)(0x80000000u + hourAngle + (uint32_t)eqTime);
+}
+
+// Calculate sun altitude and azimuth at given time of day
+int32_t AstronomyCalculatorFixed::calcSunAzEl(int64_t seconds, int64_t dayTime, uint32_t* azimuth) {
+    int32_t solarDec, eqTime;
+    calcSunPosition(seconds, &solarDec, &eqTime);
+
+    // Kept unwrapped: the azimuth quadrant test below depends on the sign
+    int64_t hourAngle = dayTime + eqTime + longitude - HALF_DAY;
+
+    int32_t sinLat = sinLatitude, cosLat = cosLatitude;
+    int32_t sinDec, cosDec, sinHA, cosHA;
+    sinCos((uint32_t)solarDec, &sinDec, &cosDec);
+    sinCos((uint32_t)hourAngle, &sinHA, &cosHA);
+
+    int32_t elevation = asin(mulQ30(sinLat, sinDec) + mulQ30(mulQ30(cosLat, cosDec), cosHA));
+
+    int32_t sinEl, cosEl;
+    sinCos((uint32_t)elevation, &sinEl, &cosEl);
+    int64_t azDenom = mulQ30(cosLat, sinEl);
+    if (azDenom > Q30_ONE / 1000 || azDenom < -Q30_ONE / 1000) {
+        int64_t azNum = (int64_t)mulQ30(sinLat, cosEl) - sinDec;
+        uint32_t az = acos(clampQ30(azNum * Q30_ONE / azDenom));
+        if (hourAngle > 0) {
+            az = 0u - az;
+        }
+        *azimuth = az;
+    } else {
+        *azimuth = (latitude > 0) ? 0x80000000u : 0;
+    }
+
+    return elevation;
+}
+
+// Simplified moon position calculation
+void AstronomyCalculatorFixed::calcMoonPosition(int64_t seconds, uint32_t* moonRA, int32_t* moonDec) {
+    uint32_t L = meanAngle(MOON_MEAN_LONGITUDE, MOON_MEAN_LONGITUDE_RATE, seconds);
+    uint32_t M = meanAngle(MOON_MEAN_ANOMALY, MOON_MEAN_ANOMALY_RATE, seconds);
+    uint32_t F = meanAngle(MOON_ARGUMENT_OF_LATITUDE, MOON_ARGUMENT_OF_LATITUDE_RATE, seconds);
+
+    int32_t sinM, cosM, sinF, cosF;
+    sinCos(M, &sinM, &cosM);
+    sinCos(F, &sinF, &cosF);
+
+    uint32_t lon = L + mulQ30(MOON_CENTRE, sinM);
+    int32_t lat = mulQ30(MOON_LATITUDE_AMPLITUDE, sinF);
+
+    int32_t sinLon, cosLon, sinLat, cosLat;
+    sinCos(lon, &sinLon, &cosLon);
+    sinCos((uint32_t)lat, &sinLat, &cosLat);
+
+    // atan2 arguments scaled by cos(lat) > 0 to avoid tan(lat)
+    *moonRA = atan2(mulQ30(mulQ30(sinLon, COS_EPSILON), cosLat) - mulQ30(sinLat, SIN_EPSILON),
+                    mulQ30(cosLon, cosLat));
+    *moonDec = asin(mulQ30(sinLat, COS_EPSILON) + mulQ30(mulQ30(cosLat, SIN_EPSILON), sinLon));
+}
+
+// Calculate the astronomical phase angle (sun-moon-earth): 0 = full, 2^31 = new
+uint32_t AstronomyCalculatorFixed::calcMoonPhaseAngle(int64_t seconds) const {
+    uint32_t M = meanAngle(MOON_MEAN_ANOMALY, MOON_MEAN_ANOMALY_RATE, seconds);
+    uint32_t Msun = meanAngle(PHASE_SUN_ANOMALY, PHASE_SUN_ANOMALY_RATE, seconds);
+    uint32_t D = meanAngle(PHASE_ELONGATION, PHASE_ELONGATION_RATE, seconds);
+
+    int32_t sinM, cosM, sinMsun, cosMsun;
+    sinCos(M, &sinM, &cosM);
+    sinCos(Msun, &sinMsun, &cosMsun);
+
+    return 0x80000000u - D - (uint32_t)mulQ30(MOON_CENTRE, sinM) + (uint32_t)mulQ30(PHASE_SUN_TERM, sinMsun);
+}
+
+// Calculate moonrise (simplified)
+int64_t AstronomyCalculatorFixed::calcMoonrise(int64_t seconds) {
+    uint32_t moonRA;
+    int32_t moonDec;
+    calcMoonPosition(seconds, &moonRA, &moonDec);
+
+    bool valid;
+    uint32_t hourAngle = calcHourAngle(COS_MOON_ZENITH, moonDec, &valid);
+    if (!valid) return NO_EVENT;
+
+    return (uint32_t)(moonRA - hourAngle + (uint32_t)longitude);
+}
+
+// Calculate moonset (simplified)
+int64_t AstronomyCalculatorFixed::calcMoonset(int64_t seconds) {
+    uint32_t moonRA;
+    int32_t moonDec;
+    calcMoonPosition(seconds, &moonRA, &moonDec);
+
+    bool valid;
+    uint32_t hourAngle = calcHourAngle(COS_MOON_ZENITH, moonDec, &valid);
+    if (!valid) return NO_EVENT;
+
+    return (uint32_t)(moonRA + hourAngle + (uint32_t)longitude);
+}
+
+// Calculate moon altitude and azimuth
+int32_t AstronomyCalculatorFixed::calcMoonAzEl(int64_t seconds, int64_t dayTime, uint32_t* azimuth) {
+    uint32_t moonRA;
+    int32_t moonDec;
+    calcMoonPosition(seconds, &moonRA, &moonDec);
+
+    uint32_t hourAngle = (uint32_t)dayTime + (uint32_t)longitude - moonRA;
+
+    int32_t sinLat = sinLatitude, cosLat = cosLatitude;
+    int32_t sinDec, cosDec, sinHA, cosHA;
+    sinCos((uint32_t)moonDec, &sinDec, &cosDec);
+    sinCos(hourAngle, &sinHA, &cosHA);
+
+    int32_t elevation = asin(mulQ30(sinLat, sinDec) + mulQ30(mulQ30(cosLat, cosDec), cosHA));
+
+    // atan2 arguments scaled by cos(dec) > 0 to avoid tan(dec)
+    *azimuth = atan2(mulQ30(sinHA, cosDec), mulQ30(mulQ30(cosHA, sinLat), cosDec) - mulQ30(sinDec, cosLat)) + 0x80000000u;
+
+    return elevation;
+}
+
+// Format time of day as HHMM string
+std::string AstronomyCalculatorFixed::formatTime(int64_t dayTime) {
+    if (dayTime < 0) return "";
+
+    int minutes = (int)((dayTime * 1440) >> 32); // Truncated, as in formatTime(double)
+    int h = (minutes / 60) % 24;
+    int m = minutes % 60;
+
+    char buffer[6];
+    snprintf(buffer, sizeof(buffer), "%02d%02d", h, m);
+    return std::string(buffer);
+}
+
+// Convert a time-of-day span to minutes
+int AstronomyCalculatorFixed::dayTimeToMinutes(int64_t dayTime) {
+    return (int)((dayTime * 1440 + HALF_DAY) >> 32); // Round to nearest minute
+}
+
+// Get moon phase description
+std::string AstronomyCalculatorFixed::moonPhase() {
+    return AstronomyCalculator::moonPhaseName(moonPhaseIndex());
+}
+
+// Get moon phase as one of eight 45 degree sectors centred on 0, 45, 90, ...
+int AstronomyCalculatorFixed::moonPhaseIndex() const {
+    return (int)((moonPhaseAngle() + PHASE_HALF_SECTOR) >> 29);
+}
+
+// Get continuous moon phase angle; supplement of the astronomical phase angle
+uint32_t AstronomyCalculatorFixed::moonPhaseAngle() const {
+    return 0x80000000u - calcMoonPhaseAngle(secondsSinceJ2000);
+}
+
+// Get illuminated fraction of the moon's disk
+int32_t AstronomyCalculatorFixed::moonIlluminatedFraction() const {
+    int32_t sinPhase, cosPhase;
+    sinCos(moonPhaseAngle(), &sinPhase, &cosPhase);
+    return (Q30_ONE - cosPhase) / 2;
+}
+
+// Check whether the illuminated fraction is growing
+bool AstronomyCalculatorFixed::isMoonWaxing() const {
+    return moonPhaseAngle() < 0x80000000u;
+}
@@ -0,0 +1,119 @@
+#ifndef ASTRONOMY_CALCULATOR_FIXED_H
+#define ASTRONOMY_CALCULATOR_FIXED_H
+
+#include <cstdint>
+#include <ctime>
+#include <string>
+
+// Integer-only counterpart of AstronomyCalculator for FPU-less targets
+// (ESP32-C3 and other RISC-V parts). Same public members, same algorithms.
+//
+// Number formats:
+//   - Angles are binary angle units (BAM): uint32_t, 2^32 == 360 degrees.
+//     Signed quantities (altitude, hour angle) are the same bits as int32_t.
+//   - Times of day are also BAM of a day: 2^32 == 24 hours, so an hour angle
+//     converts to a time of day without any scaling.
+//   - Sines, cosines and ratios are Q30 (1.0 == 1 << 30).
+//   - Trig uses CORDIC (sin/cos in rotation mode, atan2 in vectoring mode);
+//     asin/acos are built from atan2 and an integer square root.
+//
+// Tolerances against AstronomyCalculator (checked by the native test suite):
+//   - minute counts and HHMM strings: +/- 2 minutes
+//   - altitude/azimuth at rise: +/- 0.05 degrees
+//   - booleans, phase names and the last/next event selection can differ
+//     only when the underlying event is within a minute of the decision
+//     boundary (e.g. moon altitude within a few arc-seconds of 0).
+//
+// The only floating point left is the double constructor (fromMicroDegrees
+// avoids it) and the four double altitude/azimuth members, each a single
+// conversion at the end.
+class AstronomyCalculatorFixed {
+private:
+    // Input parameters
+    int32_t latitude;   // BAM, signed
+    int32_t longitude;  // BAM, signed (also the longitude's time offset)
+    time_t timestamp;
+
+    // Common calculations
+    int32_t sinLatitude;  // Q30
+    int32_t cosLatitude;  // Q30
+    int64_t secondsSinceJ2000;
+    uint32_t localTime;  // BAM of day
+
+    // Shared by the public constructors; the flag only disambiguates overloads
+    AstronomyCalculatorFixed(int32_t latAngle, int32_t lngAngle, time_t unixTime, bool);
+
+    // Internal calculation methods (times of day are int64_t so that the
+    // negative sentinels of AstronomyCalculator carry over unchanged)
+    void calcSunPosition(int64_t seconds, int32_t* declination, int32_t* eqTime);
+    uint32_t calcHourAngle(int32_t cosZenith, int32_t dec, bool* valid);
+    int64_t calcSunrise(int64_t seconds);
+    int64_t calcSunset(int64_t seconds);
+    int32_t calcSunAzEl(int64_t seconds, int64_t dayTime, uint32_t* azimuth);
+
+    // Moon calculation methods
+    void calcMoonPosition(int64_t seconds, uint32_t* moonRA, int32_t* moonDec);
+    uint32_t calcMoonPhaseAngle(int64_t seconds) const;
+    int64_t calcMoonrise(int64_t seconds);
+    int64_t calcMoonset(int64_t seconds);
+    int32_t calcMoonAzEl(int64_t seconds, int64_t dayTime, uint32_t* azimuth);
+
+    // Utility methods
+    std::string formatTime(int64_t dayTime);
+    int dayTimeToMinutes(int64_t dayTime);
+
+public:
+    // Fixed-point primitives, public so they can be tested and reused
+    static constexpr int32_t Q30_ONE = 1 << 30;
+    static int32_t mulQ30(int32_t a, int32_t b);
+    static void sinCos(uint32_t angle, int32_t* sinOut, int32_t* cosOut);
+    static uint32_t atan2(int32_t y, int32_t x);
+    static int32_t asin(int32_t value);
+    static uint32_t acos(int32_t value);
+    static int32_t degreesToAngle(double degrees);
+    static int32_t microDegreesToAngle(int32_t microDegrees);
+    static double angleToDegrees(int32_t angle);
+    static double bearingToDegrees(uint32_t angle);
+
+    // Constructor - drop-in replacement for AstronomyCalculator
+    AstronomyCalculatorFixed(double lat, double lng, time_t unixTime);
+
+    // Float-free construction from millionths of a degree
+    static AstronomyCalculatorFixed fromMicroDegrees(int32_t latMicroDeg, int32_t lngMicroDeg, time_t unixTime);
+
+    // Public member variables - calculated on construction
+    bool isMoonVisible;
+    int minutesSinceLastMoonRise;
+    int minutesSinceLastMoonSet;
+    int minutesUntilNextMoonRise;
+    int minutesUntilNextMoonSet;
+
+    std::string nextMoonRiseHHMM;
+    std::string nextMoonSetHHMM;
+    std::string lastMoonRiseHHMM;
+    std::string lastMoonSetHHMM;
+
+    std::string sunRiseTodayHHMM;
+    std::string sunSetTodayHHMM;
+    int minutesSinceSunRise;
+    int minutesSinceSunSet;
+    int minutesUntilSunSet;
+    int minutesUntilSunRise;
+
+    double sunAltitudeAtRise;
+    double sunAzimuthAtRise;
+    double moonAltitudeAtRise;
+    double moonAzimuthAtRise;
+
+    int minutesSunVisible;
+    int minutesMoonVisible;
+
+    // Public methods
+    std::string moonPhase();
+    int moonPhaseIndex() const; // 0 = New Moon ... 7 = Waning Crescent
+    uint32_t moonPhaseAngle() const; // BAM, 0 = new, 2^31 = full
+    int32_t moonIlluminatedFraction() const; // Q30, 0 (new) to Q30_ONE (full)
+    bool isMoonWaxing() const;
+};
+
+#endif
@@ -0,0 +1,194 @@
+#include "AstronomyQuery.h"
+#include "CivilDate.h"
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <string>
+
+namespace {
+
+bool parseDigits(const char*& p, const char* end, int count, int* value) {
+    *value = 0;
+    for (int i = 0; i < count; i++, p++) {
+        if (p >= end || *p < '0' || *p > '9') return false;
+        *value = *value * 10 + (*p - '0');
+    }
+    return true;
+}
+
+bool parseNumber(const char* p, const char* end, double* value) {
+    while (p < end && *p == ' ') p++;
+    while (end > p && end[-1] == ' ') end--;
+    if (p >= end || end - p > 64) return false;
+    char text[65];
+    memcpy(text, p, end - p);
+    text[end - p] = '\0';
+    char* stop;
+    *value = strtod(text, &stop);
+    return *stop == '\0';
+}
+
+// Whole seconds, at least 1; rejects NaN, infinities and anything beyond
+// int64 before the conversion, which would otherwise be undefined
+bool parseStep(const char* p, const char* end, int64_t* step) {
+    double value;
+    if (!parseNumber(p, end, &value)) return false;
+    if (!(value >= 1.0 && value < 9223372036854775808.0)) return false; // 2^63
+    *step = (int64_t)value;
+    return true;
+}
+
+// True if the time fits time_t and has a local date
+bool representable(int64_t seconds) {
+    time_t t = (time_t)seconds;
+    struct tm local;
+    return (int64_t)t == seconds && localtime_r(&t, &local) != nullptr;
+}
+
+bool finishQuery(AstronomyQuery* query, bool haveTime, bool haveFrom, bool haveTo) {
+    if (haveTime == (haveFrom || haveTo)) return false;
+    if (haveTime) query->to = query->from;
+    else if (!haveFrom || !haveTo || query->to < query->from) return false;
+    // Every time in the range lies between the two ends
+    if (!representable(query->from) || !representable(query->to)) return false;
+    return query->step > 0 && query->lat >= -90.0 && query->lat <= 90.0 &&
+           query->lng >= -180.0 && query->lng <= 180.0;
+}
+
+}
+
+// Unix seconds, YYYY-MM-DD (local noon) or YYYY-MM-DDTHH:MM[:SS][Z]
+bool AstronomyQueryParser::parseTime(const char* p, const char* end, int64_t* result) {
+    while (p < end && *p == ' ') p++;
+    while (end > p && end[-1] == ' ') end--;
+    if (p >= end) return false;
+
+    const char* dash = (const char*)memchr(p + 1, '-', end - p - 1);
+    if (dash == nullptr) {
+        char* stop;
+        std::string text(p, end);
+        long long seconds = strtoll(text.c_str(), &stop, 10);
+        if (*stop != '\0') return false;
+        *result = seconds;
+        return true;
+    }
+
+    int year, month, day, hour = 12, minute = 0, second = 0;
+    if (!parseDigits(p, end, 4, &year) || p >= end || *p++ != '-' ||
+        !parseDigits(p, end, 2, &month) || p >= end || *p++ != '-' ||
+        !parseDigits(p, end, 2, &day) || month < 1 || month > 12 || day < 1 ||
+        day > daysInMonth(year, month)) {
+        return false;
+    }
+    bool utc = false;
+    if (p < end) {
+        if ((*p != 'T' && *p != ' ') || !parseDigits(++p, end, 2, &hour) ||
+            p >= end || *p++ != ':' || !parseDigits(p, end, 2, &minute)) {
+            return false;
+        }
+        if (p < end && *p == ':' && !parseDigits(++p, end, 2, &second)) return false;
+        if (p < end && *p == 'Z') {
+            utc = true;
+            p++;
+        }
+        if (p != end || hour > 23 || minute > 59 || second > 60) return false;
+    }
+
+    if (utc) {
+        *result = daysFromCivil(year, month, day) * 86400 + hour * 3600 + minute * 60 + second;
+        return true;
+    }
+    struct tm local = {};
+    local.tm_year = year - 1900;
+    local.tm_mon = month - 1;
+    local.tm_mday = day;
+    local.tm_hour = hour;
+    local.tm_min = minute;
+    local.tm_sec = second;
+    local.tm_isdst = -1;
+    time_t seconds = mktime(&local);
+    if (seconds == (time_t)-1) return false;
+    *result = seconds;
+    return true;
+}
+
+// lat,lng,time or lat,lng,from,to[,step]
+bool AstronomyQueryParser::parseCsv(const char* line, size_t length, AstronomyQuery* query) {
+    const char* fields[6];
+    const char* ends[6];
+    int count = 0;
+    const char* p = line;
+    const char* end = line + length;
+    while (count < 6) {
+        const char* comma = (const char*)memchr(p, ',', end - p);
+        fields[count] = p;
+        ends[count] = comma ? comma : end;
+        count++;
+        if (comma == nullptr) break;
+        p = comma + 1;
+    }
+    if (count < 3 || count > 5 || ends[count - 1] != end) return false;
+
+    query->step = DEFAULT_STEP;
+    if (!parseNumber(fields[0], ends[0], &query->lat) || !parseNumber(fields[1], ends[1], &query->lng) ||
+        !parseTime(fields[2], ends[2], &query->from)) {
+        return false;
+    }
+    if (count == 3) return finishQuery(query, true, false, false);
+    if (!parseTime(fields[3], ends[3], &query->to)) return false;
+    if (count == 5 && !parseStep(fields[4], ends[4], &query->step)) return false;
+    return finishQuery(query, false, true, true);
+}
+
+// Flat object with lat, lng and time or from/to[/step]; other keys are ignored
+bool AstronomyQueryParser::parseNdjson(const char* line, size_t length, AstronomyQuery* query) {
+    const char* p = line;
+    const char* end = line + length;
+    auto skipSpace = [&]() { while (p < end && (*p == ' ' || *p == '\t')) p++; };
+
+    skipSpace();
+    if (p >= end || *p++ != '{') return false;
+
+    bool haveLat = false, haveLng = false, haveTime = false, haveFrom = false, haveTo = false;
+    query->step = DEFAULT_STEP;
+    for (;;) {
+        skipSpace();
+        if (p < end && *p == '}') break;
+        if (p >= end || *p++ != '"') return false;
+        const char* key = p;
+        while (p < end && *p != '"') p++;
+        if (p >= end) return false;
+        std::string name(key, p++);
+        skipSpace();
+        if (p >= end || *p++ != ':') return false;
+        skipSpace();
+
+        const char* value = p;
+        const char* valueEnd;
+        if (p < end && *p == '"') {
+            value = ++p;
+            while (p < end && *p != '"') p++;
+            if (p >= end) return false;
+            valueEnd = p++;
+        } else {
+            while (p < end && *p != ',' && *p != '}') p++;
+            valueEnd = p;
+        }
+
+        if (name == "lat") haveLat = parseNumber(value, valueEnd, &query->lat);
+        else if (name == "lng" || name == "lon") haveLng = parseNumber(value, valueEnd, &query->lng);
+        else if (name == "time") haveTime = parseTime(value, valueEnd, &query->from);
+        else if (name == "from") haveFrom = parseTime(value, valueEnd, &query->from);
+        else if (name == "to") haveTo = parseTime(value, valueEnd, &query->to);
+        else if (name == "step" && !parseStep(value, valueEnd, &query->step)) return false;
+
+        skipSpace();
+        if (p < end && *p == ',') {
+            p++;
+            continue;
+        }
+        if (p >= end || *p != '}') return false;
+        break;
+    }
+    return haveLat && haveLng && finishQuery(query, haveTime, haveFrom, haveTo);
+}
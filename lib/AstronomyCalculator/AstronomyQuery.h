@@ -0,0 +1,38 @@
+#ifndef ASTRONOMY_QUERY_H
+#define ASTRONOMY_QUERY_H
+
+#include <cstddef>
+#include <cstdint>
+
+// One batch query: a location and a single time (from == to) or a range of
+// times from..to every step seconds
+struct AstronomyQuery {
+    double lat;
+    double lng;
+    int64_t from;
+    int64_t to;
+    int64_t step;
+};
+
+// Line parsers for the batch tool's CSV and NDJSON input.
+//
+//   CSV     lat,lng,time  or  lat,lng,from,to[,step]
+//   NDJSON  flat object with "lat", "lng" (or "lon") and "time" or
+//           "from"/"to"[/"step"]; other keys are ignored
+//
+// Times are Unix seconds, YYYY-MM-DD (local noon) or
+// YYYY-MM-DDTHH:MM[:SS][Z]; local times use the process time zone. A line is
+// rejected unless every time is a real calendar date the C library can
+// represent as local time, the coordinates are in range and the step is a
+// positive number of seconds that fits int64 (fractions are truncated).
+class AstronomyQueryParser {
+public:
+    static constexpr int64_t DEFAULT_STEP = 86400;
+
+    // Each returns false on malformed input; *query is then unspecified
+    static bool parseTime(const char* text, const char* end, int64_t* result);
+    static bool parseCsv(const char* line, size_t length, AstronomyQuery* query);
+    static bool parseNdjson(const char* line, size_t length, AstronomyQuery* query);
+};
+
+#endif
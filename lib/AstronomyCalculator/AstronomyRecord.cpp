@@ -0,0 +1,62 @@
+#include "AstronomyRecord.h"
+#include "AstronomyCalculator.h"
+#include "AstronomyCalculatorFixed.h"
+#include <cstring>
+
+namespace {
+
+// Copy an HHMM string into its inline slot, truncating anything longer
+void copyClock(char* dest, const std::string& src) {
+    size_t length = std::min(src.size(), (size_t)4);
+    memcpy(dest, src.data(), length);
+    dest[length] = '\0';
+}
+
+// Both calculators expose the same public members
+template <typename Calculator>
+void capture(AstronomyRecord* record, const Calculator& astro) {
+    memset(record, 0, sizeof(*record));
+
+    record->isMoonVisible = astro.isMoonVisible;
+    record->minutesSinceLastMoonRise = astro.minutesSinceLastMoonRise;
+    record->minutesSinceLastMoonSet = astro.minutesSinceLastMoonSet;
+    record->minutesUntilNextMoonRise = astro.minutesUntilNextMoonRise;
+    record->minutesUntilNextMoonSet = astro.minutesUntilNextMoonSet;
+
+    copyClock(record->nextMoonRiseHHMM, astro.nextMoonRiseHHMM);
+    copyClock(record->nextMoonSetHHMM, astro.nextMoonSetHHMM);
+    copyClock(record->lastMoonRiseHHMM, astro.lastMoonRiseHHMM);
+    copyClock(record->lastMoonSetHHMM, astro.lastMoonSetHHMM);
+
+    copyClock(record->sunRiseTodayHHMM, astro.sunRiseTodayHHMM);
+    copyClock(record->sunSetTodayHHMM, astro.sunSetTodayHHMM);
+    record->minutesSinceSunRise = astro.minutesSinceSunRise;
+    record->minutesSinceSunSet = astro.minutesSinceSunSet;
+    record->minutesUntilSunSet = astro.minutesUntilSunSet;
+    record->minutesUntilSunRise = astro.minutesUntilSunRise;
+
+    record->sunAltitudeAtRise = astro.sunAltitudeAtRise;
+    record->sunAzimuthAtRise = astro.sunAzimuthAtRise;
+    record->moonAltitudeAtRise = astro.moonAltitudeAtRise;
+    record->moonAzimuthAtRise = astro.moonAzimuthAtRise;
+
+    record->minutesSunVisible = astro.minutesSunVisible;
+    record->minutesMoonVisible = astro.minutesMoonVisible;
+
+    record->moonPhaseIndex = astro.moonPhaseIndex();
+}
+
+}
+
+AstronomyRecord::AstronomyRecord(const AstronomyCalculator& astro) {
+    capture(this, astro);
+}
+
+AstronomyRecord::AstronomyRecord(const AstronomyCalculatorFixed& astro) {
+    capture(this, astro);
+}
+
+// Get moon phase description
+const char* AstronomyRecord::moonPhase() const {
+    return AstronomyCalculator::moonPhaseName(moonPhaseIndex);
+}
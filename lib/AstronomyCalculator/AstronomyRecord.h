@@ -0,0 +1,50 @@
+#ifndef ASTRONOMY_RECORD_H
+#define ASTRONOMY_RECORD_H
+
+#include <cstdint>
+
+class AstronomyCalculator;
+class AstronomyCalculatorFixed;
+
+// Trivially copyable snapshot of every public AstronomyCalculator result.
+// HHMM strings are stored inline ("" when absent) so records can be copied,
+// cached and serialized without touching the heap.
+struct AstronomyRecord {
+    bool isMoonVisible;
+    int minutesSinceLastMoonRise;
+    int minutesSinceLastMoonSet;
+    int minutesUntilNextMoonRise;
+    int minutesUntilNextMoonSet;
+
+    char nextMoonRiseHHMM[5];
+    char nextMoonSetHHMM[5];
+    char lastMoonRiseHHMM[5];
+    char lastMoonSetHHMM[5];
+
+    char sunRiseTodayHHMM[5];
+    char sunSetTodayHHMM[5];
+    int minutesSinceSunRise;
+    int minutesSinceSunSet;
+    int minutesUntilSunSet;
+    int minutesUntilSunRise;
+
+    double sunAltitudeAtRise;
+    double sunAzimuthAtRise;
+    double moonAltitudeAtRise;
+    double moonAzimuthAtRise;
+
+    int minutesSunVisible;
+    int minutesMoonVisible;
+
+    int moonPhaseIndex; // see AstronomyCalculator::moonPhaseIndex()
+
+    // Constructors
+    AstronomyRecord() = default;
+    explicit AstronomyRecord(const AstronomyCalculator& astro);
+    explicit AstronomyRecord(const AstronomyCalculatorFixed& astro);
+
+    // Public methods
+    const char* moonPhase() const;
+};
+
+#endif
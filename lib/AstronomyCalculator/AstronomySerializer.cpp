@@ -0,0 +1,513 @@
+#include "AstronomySerializer.h"
+#include "AstronomyCalculator.h"
+#include <cstring>
+
+namespace {
+
+enum FieldType { FIELD_BOOL, FIELD_MINUTES, FIELD_CLOCK, FIELD_ANGLE, FIELD_PHASE };
+
+struct FieldInfo {
+    const char* name;
+    FieldType type;
+    size_t offset;
+};
+
+#define ASTRONOMY_FIELD(name, type) { #name, type, offsetof(AstronomyRecord, name) }
+
+// Single table driving both encodings and both decoders
+constexpr FieldInfo FIELDS[] = {
+    ASTRONOMY_FIELD(isMoonVisible, FIELD_BOOL),
+    ASTRONOMY_FIELD(minutesSinceLastMoonRise, FIELD_MINUTES),
+    ASTRONOMY_FIELD(minutesSinceLastMoonSet, FIELD_MINUTES),
+    ASTRONOMY_FIELD(minutesUntilNextMoonRise, FIELD_MINUTES),
+    ASTRONOMY_FIELD(minutesUntilNextMoonSet, FIELD_MINUTES),
+    ASTRONOMY_FIELD(nextMoonRiseHHMM, FIELD_CLOCK),
+    ASTRONOMY_FIELD(nextMoonSetHHMM, FIELD_CLOCK),
+    ASTRONOMY_FIELD(lastMoonRiseHHMM, FIELD_CLOCK),
+    ASTRONOMY_FIELD(lastMoonSetHHMM, FIELD_CLOCK),
+    ASTRONOMY_FIELD(sunRiseTodayHHMM, FIELD_CLOCK),
+    ASTRONOMY_FIELD(sunSetTodayHHMM, FIELD_CLOCK),
+    ASTRONOMY_FIELD(minutesSinceSunRise, FIELD_MINUTES),
+    ASTRONOMY_FIELD(minutesSinceSunSet, FIELD_MINUTES),
+    ASTRONOMY_FIELD(minutesUntilSunSet, FIELD_MINUTES),
+    ASTRONOMY_FIELD(minutesUntilSunRise, FIELD_MINUTES),
+    ASTRONOMY_FIELD(sunAltitudeAtRise, FIELD_ANGLE),
+    ASTRONOMY_FIELD(sunAzimuthAtRise, FIELD_ANGLE),
+    ASTRONOMY_FIELD(moonAltitudeAtRise, FIELD_ANGLE),
+    ASTRONOMY_FIELD(moonAzimuthAtRise, FIELD_ANGLE),
+    ASTRONOMY_FIELD(minutesSunVisible, FIELD_MINUTES),
+    ASTRONOMY_FIELD(minutesMoonVisible, FIELD_MINUTES),
+    { "moonPhase", FIELD_PHASE, offsetof(AstronomyRecord, moonPhaseIndex) }
+};
+
+#undef ASTRONOMY_FIELD
+
+constexpr size_t FIELD_COUNT = sizeof(FIELDS) / sizeof(FIELDS[0]);
+
+// Angles are fixed-point with five decimals in both encodings
+const double ANGLE_SCALE = 100000.0;
+const double ANGLE_LIMIT = 21000.0; // keeps scaled values inside int32
+
+int32_t scaleAngle(double degrees) {
+    if (!(degrees > -ANGLE_LIMIT)) degrees = -ANGLE_LIMIT; // also catches NaN
+    if (degrees > ANGLE_LIMIT) degrees = ANGLE_LIMIT;
+    double scaled = degrees * ANGLE_SCALE;
+    return (int32_t)(scaled < 0 ? scaled - 0.5 : scaled + 0.5);
+}
+
+// "HHMM" -> minutes of day, -1 when empty or malformed
+int clockToMinutes(const char* hhmm) {
+    for (int i = 0; i < 4; i++) {
+        if (hhmm[i] < '0' || hhmm[i] > '9') return -1;
+    }
+    return ((hhmm[0] - '0') * 10 + (hhmm[1] - '0')) * 60 + (hhmm[2] - '0') * 10 + (hhmm[3] - '0');
+}
+
+void minutesToClock(int minutes, char* hhmm) {
+    if (minutes < 0 || minutes >= 1440) {
+        hhmm[0] = '\0';
+        return;
+    }
+    int h = minutes / 60, m = minutes % 60;
+    hhmm[0] = (char)('0' + h / 10);
+    hhmm[1] = (char)('0' + h % 10);
+    hhmm[2] = (char)('0' + m / 10);
+    hhmm[3] = (char)('0' + m % 10);
+    hhmm[4] = '\0';
+}
+
+// Format an integer right-aligned into the end of buf; returns start
+char* formatInt(int64_t value, char* end) {
+    uint64_t magnitude = value < 0 ? 0 - (uint64_t)value : (uint64_t)value;
+    char* p = end;
+    do {
+        *--p = (char)('0' + magnitude % 10);
+        magnitude /= 10;
+    } while (magnitude != 0);
+    if (value < 0) *--p = '-';
+    return p;
+}
+
+// Buffered writer that either fills one buffer or flushes chunks to a sink
+class Output {
+public:
+    Output(char* buffer, size_t capacity, AstronomySink sink, void* context)
+        : buffer(buffer), capacity(capacity), used(0), sink(sink), context(context), failed(false) {}
+
+    void put(const char* data, size_t length) {
+        while (length > 0 && !failed) {
+            if (used == capacity && !flush()) return;
+            size_t n = std::min(length, capacity - used);
+            memcpy(buffer + used, data, n);
+            used += n;
+            data += n;
+            length -= n;
+        }
+    }
+
+    void put(const char* text) { put(text, strlen(text)); }
+
+    void putChar(char c) { put(&c, 1); }
+
+    void putInt(int64_t value) {
+        char digits[24];
+        char* end = digits + sizeof(digits);
+        char* start = formatInt(value, end);
+        put(start, end - start);
+    }
+
+    void putAngle(double degrees) {
+        int32_t scaled = scaleAngle(degrees);
+        uint32_t magnitude = scaled < 0 ? 0u - (uint32_t)scaled : (uint32_t)scaled;
+        if (scaled < 0) putChar('-');
+        putInt(magnitude / 100000);
+
+        char fraction[6] = { '.', '0', '0', '0', '0', '0' };
+        uint32_t rest = magnitude % 100000;
+        for (int i = 5; i >= 1; i--) {
+            fraction[i] = (char)('0' + rest % 10);
+            rest /= 10;
+        }
+        put(fraction, sizeof(fraction));
+    }
+
+    bool flush() {
+        if (sink == nullptr || failed || !sink(context, buffer, used)) {
+            failed = true;
+            return false;
+        }
+        used = 0;
+        return true;
+    }
+
+    char* buffer;
+    size_t capacity;
+    size_t used;
+    AstronomySink sink;
+    void* context;
+    bool failed;
+};
+
+void writeJsonFields(const AstronomyRecord& record, Output& out) {
+    const char* base = (const char*)&record;
+    out.putChar('{');
+    for (size_t i = 0; i < FIELD_COUNT; i++) {
+        const FieldInfo& field = FIELDS[i];
+        if (i > 0) out.putChar(',');
+        out.putChar('"');
+        out.put(field.name);
+        out.put("\":", 2);
+
+        switch (field.type) {
+            case FIELD_BOOL:
+                out.put(*(const bool*)(base + field.offset) ? "true" : "false");
+                break;
+            case FIELD_MINUTES:
+                out.putInt(*(const int*)(base + field.offset));
+                break;
+            case FIELD_CLOCK: {
+                // Normalized through minutes so garbage never reaches the output
+                char hhmm[5];
+                minutesToClock(clockToMinutes(base + field.offset), hhmm);
+                out.putChar('"');
+                out.put(hhmm);
+                out.putChar('"');
+                break;
+            }
+            case FIELD_ANGLE:
+                out.putAngle(*(const double*)(base + field.offset));
+                break;
+            case FIELD_PHASE:
+                out.putChar('"');
+                out.put(AstronomyCalculator::moonPhaseName(*(const int*)(base + field.offset)));
+                out.putChar('"');
+                break;
+        }
+    }
+    out.putChar('}');
+}
+
+// Same fields and value formats as JSON, without keys or quotes
+void writeCsvFields(const AstronomyRecord& record, Output& out) {
+    const char* base = (const char*)&record;
+    for (size_t i = 0; i < FIELD_COUNT; i++) {
+        const FieldInfo& field = FIELDS[i];
+        if (i > 0) out.putChar(',');
+
+        switch (field.type) {
+            case FIELD_BOOL:
+                out.put(*(const bool*)(base + field.offset) ? "true" : "false");
+                break;
+            case FIELD_MINUTES:
+                out.putInt(*(const int*)(base + field.offset));
+                break;
+            case FIELD_CLOCK: {
+                char hhmm[5];
+                minutesToClock(clockToMinutes(base + field.offset), hhmm);
+                out.put(hhmm);
+                break;
+            }
+            case FIELD_ANGLE:
+                out.putAngle(*(const double*)(base + field.offset));
+                break;
+            case FIELD_PHASE:
+                out.put(AstronomyCalculator::moonPhaseName(*(const int*)(base + field.offset)));
+                break;
+        }
+    }
+}
+
+void putLE(uint8_t* p, uint32_t value, int bytes) {
+    for (int i = 0; i < bytes; i++) {
+        p[i] = (uint8_t)(value >> (8 * i));
+    }
+}
+
+uint32_t getLE(const uint8_t* p, int bytes) {
+    uint32_t value = 0;
+    for (int i = 0; i < bytes; i++) {
+        value |= (uint32_t)p[i] << (8 * i);
+    }
+    return value;
+}
+
+constexpr int fieldBinarySize(FieldType type) {
+    return (type == FIELD_MINUTES || type == FIELD_CLOCK) ? 2 : (type == FIELD_ANGLE ? 4 : 1);
+}
+
+// Version byte plus every field in the table
+constexpr size_t binarySize(size_t i = 0) {
+    return i == FIELD_COUNT ? 1 : fieldBinarySize(FIELDS[i].type) + binarySize(i + 1);
+}
+
+static_assert(binarySize() == AstronomySerializer::BINARY_SIZE,
+              "BINARY_SIZE must match the FIELDS table");
+
+void encodeBinary(const AstronomyRecord& record, uint8_t* out) {
+    const char* base = (const char*)&record;
+    *out++ = AstronomySerializer::BINARY_VERSION;
+    for (size_t i = 0; i < FIELD_COUNT; i++) {
+        const FieldInfo& field = FIELDS[i];
+        const char* value = base + field.offset;
+        switch (field.type) {
+            case FIELD_BOOL:
+                out[0] = *(const bool*)value ? 1 : 0;
+                break;
+            case FIELD_MINUTES: {
+                int minutes = *(const int*)value;
+                if (minutes > INT16_MAX) minutes = INT16_MAX;
+                if (minutes < INT16_MIN) minutes = INT16_MIN;
+                putLE(out, (uint16_t)(int16_t)minutes, 2);
+                break;
+            }
+            case FIELD_CLOCK: {
+                int minutes = clockToMinutes(value);
+                putLE(out, minutes < 0 ? 0xFFFF : (uint32_t)minutes, 2);
+                break;
+            }
+            case FIELD_ANGLE:
+                putLE(out, (uint32_t)scaleAngle(*(const double*)value), 4);
+                break;
+            case FIELD_PHASE:
+                out[0] = (uint8_t)*(const int*)value;
+                break;
+        }
+        out += fieldBinarySize(field.type);
+    }
+}
+
+// Minimal reader for the flat JSON object produced by writeJsonFields
+class Input {
+public:
+    Input(const char* data, size_t length) : p(data), end(data + length) {}
+
+    void skipSpace() {
+        while (p < end && (*p == ' ' || *p == '\t' || *p == '\n' || *p == '\r')) p++;
+    }
+
+    bool expect(char c) {
+        skipSpace();
+        if (p >= end || *p != c) return false;
+        p++;
+        return true;
+    }
+
+    // Returns the string body without quotes; no escapes are ever emitted
+    bool readString(const char** start, size_t* length) {
+        if (!expect('"')) return false;
+        *start = p;
+        while (p < end && *p != '"') {
+            if (*p == '\\') return false;
+            p++;
+        }
+        if (p >= end) return false;
+        *length = p - *start;
+        p++;
+        return true;
+    }
+
+    bool readLiteral(const char* word) {
+        skipSpace();
+        size_t length = strlen(word);
+        if ((size_t)(end - p) < length || memcmp(p, word, length) != 0) return false;
+        p += length;
+        return true;
+    }
+
+    // Decimal number as an integer scaled by 10^decimals (extra digits
+    // dropped); false if the scaled value does not fit int64
+    bool readScaled(int decimals, int64_t* value) {
+        skipSpace();
+        bool negative = p < end && *p == '-';
+        if (negative) p++;
+        if (p >= end || *p < '0' || *p > '9') return false;
+
+        int64_t result = 0;
+        auto append = [&result](int digit) {
+            if (result > (INT64_MAX - digit) / 10) return false;
+            result = result * 10 + digit;
+            return true;
+        };
+
+        while (p < end && *p >= '0' && *p <= '9') {
+            if (!append(*p++ - '0')) return false;
+        }
+        int seen = 0;
+        if (p < end && *p == '.') {
+            p++;
+            while (p < end && *p >= '0' && *p <= '9') {
+                if (seen < decimals) {
+                    if (!append(*p - '0')) return false;
+                    seen++;
+                }
+                p++;
+            }
+        }
+        for (; seen < decimals; seen++) {
+            if (!append(0)) return false;
+        }
+
+        *value = negative ? -result : result;
+        return true;
+    }
+
+    const char* p;
+    const char* end;
+};
+
+bool readJsonValue(Input& in, const FieldInfo& field, char* base) {
+    char* value = base + field.offset;
+    switch (field.type) {
+        case FIELD_BOOL:
+            if (in.readLiteral("true")) *(bool*)value = true;
+            else if (in.readLiteral("false")) *(bool*)value = false;
+            else return false;
+            return true;
+        case FIELD_MINUTES: {
+            int64_t minutes;
+            if (!in.readScaled(0, &minutes) || minutes > INT32_MAX || minutes < INT32_MIN) return false;
+            *(int*)value = (int)minutes;
+            return true;
+        }
+        case FIELD_CLOCK: {
+            const char* start;
+            size_t length;
+            if (!in.readString(&start, &length) || (length != 0 && length != 4)) return false;
+            memcpy(value, start, length);
+            value[length] = '\0';
+            return length == 0 || clockToMinutes(value) >= 0;
+        }
+        case FIELD_ANGLE: {
+            int64_t scaled;
+            if (!in.readScaled(5, &scaled)) return false;
+            *(double*)value = scaled / ANGLE_SCALE;
+            return true;
+        }
+        case FIELD_PHASE: {
+            const char* start;
+            size_t length;
+            if (!in.readString(&start, &length)) return false;
+            for (int index = 0; index < 8; index++) {
+                const char* name = AstronomyCalculator::moonPhaseName(index);
+                if (strlen(name) == length && memcmp(name, start, length) == 0) {
+                    *(int*)value = index;
+                    return true;
+                }
+            }
+            return false;
+        }
+    }
+    return false;
+}
+
+}
+
+size_t AstronomySerializer::writeJson(const AstronomyRecord& record, char* buffer, size_t capacity) {
+    Output out(buffer, capacity, nullptr, nullptr);
+    writeJsonFields(record, out);
+    if (out.failed) return 0;
+    if (out.used < capacity) buffer[out.used] = '\0';
+    return out.used;
+}
+
+bool AstronomySerializer::writeJson(const AstronomyRecord& record, AstronomySink sink, void* context,
+                                    char* scratch, size_t scratchSize) {
+    if (sink == nullptr || scratch == nullptr || scratchSize == 0) return false;
+    Output out(scratch, scratchSize, sink, context);
+    writeJsonFields(record, out);
+    return !out.failed && (out.used == 0 || out.flush());
+}
+
+size_t AstronomySerializer::writeCsv(const AstronomyRecord& record, char* buffer, size_t capacity) {
+    Output out(buffer, capacity, nullptr, nullptr);
+    writeCsvFields(record, out);
+    if (out.failed) return 0;
+    if (out.used < capacity) buffer[out.used] = '\0';
+    return out.used;
+}
+
+size_t AstronomySerializer::writeCsvHeader(char* buffer, size_t capacity) {
+    Output out(buffer, capacity, nullptr, nullptr);
+    for (size_t i = 0; i < FIELD_COUNT; i++) {
+        if (i > 0) out.putChar(',');
+        out.put(FIELDS[i].name);
+    }
+    if (out.failed) return 0;
+    if (out.used < capacity) buffer[out.used] = '\0';
+    return out.used;
+}
+
+size_t AstronomySerializer::writeBinary(const AstronomyRecord& record, uint8_t* buffer, size_t capacity) {
+    if (capacity < BINARY_SIZE) return 0;
+    encodeBinary(record, buffer);
+    return BINARY_SIZE;
+}
+
+bool AstronomySerializer::writeBinary(const AstronomyRecord& record, AstronomySink sink, void* context) {
+    if (sink == nullptr) return false;
+    uint8_t encoded[BINARY_SIZE];
+    encodeBinary(record, encoded);
+    return sink(context, (const char*)encoded, BINARY_SIZE);
+}
+
+bool AstronomySerializer::readJson(const char* data, size_t length, AstronomyRecord* record) {
+    memset(record, 0, sizeof(*record));
+    char* base = (char*)record;
+    Input in(data, length);
+
+    // Every field must appear exactly once
+    bool seen[FIELD_COUNT] = {};
+    size_t seenCount = 0;
+
+    if (!in.expect('{')) return false;
+    do {
+        const char* key;
+        size_t keyLength;
+        if (!in.readString(&key, &keyLength) || !in.expect(':')) return false;
+
+        size_t i = 0;
+        while (i < FIELD_COUNT && !(strlen(FIELDS[i].name) == keyLength &&
+                                    memcmp(FIELDS[i].name, key, keyLength) == 0)) {
+            i++;
+        }
+        if (i == FIELD_COUNT || seen[i] || !readJsonValue(in, FIELDS[i], base)) return false;
+        seen[i] = true;
+        seenCount++;
+    } while (in.expect(','));
+
+    return in.expect('}') && seenCount == FIELD_COUNT;
+}
+
+bool AstronomySerializer::readBinary(const uint8_t* data, size_t length, AstronomyRecord* record) {
+    if (length < BINARY_SIZE || data[0] != BINARY_VERSION) return false;
+    memset(record, 0, sizeof(*record));
+    char* base = (char*)record;
+    const uint8_t* in = data + 1;
+
+    for (size_t i = 0; i < FIELD_COUNT; i++) {
+        const FieldInfo& field = FIELDS[i];
+        char* value = base + field.offset;
+        switch (field.type) {
+            case FIELD_BOOL:
+                *(bool*)value = in[0] != 0;
+                break;
+            case FIELD_MINUTES:
+                *(int*)value = (int16_t)getLE(in, 2);
+                break;
+            case FIELD_CLOCK: {
+                uint32_t minutes = getLE(in, 2);
+                minutesToClock(minutes == 0xFFFF ? -1 : (int)minutes, value);
+                break;
+            }
+            case FIELD_ANGLE:
+                *(double*)value = (int32_t)getLE(in, 4) / ANGLE_SCALE;
+                break;
+            case FIELD_PHASE:
+                if (in[0] > 7) return false;
+                *(int*)value = in[0];
+                break;
+        }
+        in += fieldBinarySize(field.type);
+    }
+    return true;
+}
@@ -0,0 +1,48 @@
+#ifndef ASTRONOMY_SERIALIZER_H
+#define ASTRONOMY_SERIALIZER_H
+
+#include <cstddef>
+#include <cstdint>
+#include "AstronomyRecord.h"
+
+// Receives serialized output one chunk at a time (e.g. an HTTP chunk writer).
+// Return false to abort serialization.
+typedef bool (*AstronomySink)(void* context, const char* data, size_t length);
+
+// Heap-free JSON and compact binary encoding of an AstronomyRecord.
+//
+// JSON is a flat object whose keys are the AstronomyCalculator member names
+// plus "moonPhase"; angles carry five decimals. CSV rows carry the same
+// values in the same order, unquoted (no value contains a comma), under the
+// header from writeCsvHeader(). The binary encoding is a
+// version byte followed by every field in declaration order, little-endian:
+//   bool          1 byte
+//   minutes       int16 (saturated)
+//   HHMM          uint16 minutes of day, 0xFFFF when empty
+//   angle         int32 in 1e-5 degrees
+//   moon phase    1 byte index
+class AstronomySerializer {
+public:
+    static constexpr uint8_t BINARY_VERSION = 1;
+    static constexpr size_t BINARY_SIZE = 51; // checked against the field table
+    static constexpr size_t JSON_MAX_SIZE = 768; // upper bound for any record
+    static constexpr size_t CSV_MAX_SIZE = 256;
+
+    // Write into a caller buffer; return bytes written (JSON is also
+    // NUL-terminated when space allows) or 0 if the buffer is too small
+    static size_t writeJson(const AstronomyRecord& record, char* buffer, size_t capacity);
+    static size_t writeBinary(const AstronomyRecord& record, uint8_t* buffer, size_t capacity);
+    static size_t writeCsv(const AstronomyRecord& record, char* buffer, size_t capacity);
+    static size_t writeCsvHeader(char* buffer, size_t capacity);
+
+    // Stream through a sink, using scratch as the chunk buffer
+    static bool writeJson(const AstronomyRecord& record, AstronomySink sink, void* context,
+                          char* scratch, size_t scratchSize);
+    static bool writeBinary(const AstronomyRecord& record, AstronomySink sink, void* context);
+
+    // Decode output of the writers above; return false on malformed input
+    static bool readJson(const char* data, size_t length, AstronomyRecord* record);
+    static bool readBinary(const uint8_t* data, size_t length, AstronomyRecord* record);
+};
+
+#endif
@@ -0,0 +1,29 @@
+#ifndef CIVIL_DATE_H
+#define CIVIL_DATE_H
+
+#include <cstdint>
+
+// Proleptic Gregorian calendar arithmetic, independent of the C library's
+// time zone handling
+
+inline bool isLeapYear(int year) {
+    return (year % 4 == 0 && year % 100 != 0) || year % 400 == 0;
+}
+
+// Days in a month (1-12) of a year
+inline int daysInMonth(int year, int month) {
+    static const int DAYS[12] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+    return (month == 2 && isLeapYear(year)) ? 29 : DAYS[month - 1];
+}
+
+// Days since 1970-01-01 of a proleptic Gregorian date
+inline int64_t daysFromCivil(int year, int month, int day) {
+    year -= month <= 2;
+    int era = (year >= 0 ? year : year - 399) / 400;
+    int yearOfEra = year - era * 400;
+    int dayOfYear = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+    int dayOfEra = yearOfEra * 365 + yearOfEra / 4 - yearOfEra / 100 + dayOfYear;
+    return (int64_t)era * 146097 + dayOfEra - 719468;
+}
+
+#endif
@@ -0,0 +1,102 @@
+#include "HorizonProfile.h"
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+
+// Constructor - single-bin flat horizon
+HorizonProfile::HorizonProfile() : HorizonProfile(1) {
+}
+
+// Constructor - flat horizon with the given azimuth resolution
+HorizonProfile::HorizonProfile(int bins)
+    : elevations(bins < 1 ? 1 : (bins > MAX_BINS ? MAX_BINS : bins), 0), lowest(0), highest(0) {
+}
+
+void HorizonProfile::updateLimits() {
+    lowest = highest = elevations[0];
+    for (int16_t e : elevations) {
+        if (e < lowest) lowest = e;
+        if (e > highest) highest = e;
+    }
+}
+
+// Set the elevation of one bin, clamped to [-90, 90] degrees
+void HorizonProfile::setElevation(int bin, double degrees) {
+    if (bin < 0 || bin >= binCount()) return;
+    if (degrees > 90.0) degrees = 90.0;
+    if (degrees < -90.0) degrees = -90.0;
+    elevations[bin] = (int16_t)lround(degrees * 100.0);
+    updateLimits();
+}
+
+double HorizonProfile::elevation(int bin) const {
+    if (bin < 0 || bin >= binCount()) return 0.0;
+    return elevations[bin] / 100.0;
+}
+
+// Minimum visible elevation at an azimuth in degrees
+double HorizonProfile::elevationAt(double azimuth) const {
+    int bins = binCount();
+    double position = fmod(azimuth, 360.0) * bins / 360.0;
+    if (position < 0) position += bins;
+
+    int index = (int)position;
+    if (index >= bins) index = 0;
+    double fraction = position - index;
+    int next = (index + 1 < bins) ? index + 1 : 0;
+
+    return (elevations[index] + (elevations[next] - elevations[index]) * fraction) / 100.0;
+}
+
+// Load from the compact file format held in memory
+bool HorizonProfile::load(const uint8_t* data, size_t length) {
+    if (length < 6 || memcmp(data, "HZN1", 4) != 0) return false;
+
+    int bins = data[4] | (data[5] << 8);
+    if (bins < 1 || bins > MAX_BINS || length < fileSize(bins)) return false;
+
+    elevations.resize(bins);
+    for (int i = 0; i < bins; i++) {
+        const uint8_t* p = data + 6 + 2 * i;
+        elevations[i] = (int16_t)(p[0] | (p[1] << 8));
+    }
+    updateLimits();
+    return true;
+}
+
+// Load from a file (SPIFFS/LittleFS paths work through the ESP32 VFS)
+bool HorizonProfile::loadFile(const char* path) {
+    FILE* file = fopen(path, "rb");
+    if (file == nullptr) return false;
+
+    uint8_t header[6];
+    bool ok = fread(header, 1, sizeof(header), file) == sizeof(header) && memcmp(header, "HZN1", 4) == 0;
+    int bins = ok ? (header[4] | (header[5] << 8)) : 0;
+    ok = ok && bins >= 1 && bins <= MAX_BINS;
+
+    std::vector<uint8_t> data;
+    if (ok) {
+        data.resize(fileSize(bins));
+        memcpy(data.data(), header, sizeof(header));
+        ok = fread(data.data() + 6, 1, data.size() - 6, file) == data.size() - 6;
+    }
+    fclose(file);
+
+    return ok && load(data.data(), data.size());
+}
+
+// Write the compact file format; returns bytes written or 0 if too small
+size_t HorizonProfile::save(uint8_t* buffer, size_t capacity) const {
+    int bins = binCount();
+    if (capacity < fileSize(bins)) return 0;
+
+    memcpy(buffer, "HZN1", 4);
+    buffer[4] = (uint8_t)(bins & 0xFF);
+    buffer[5] = (uint8_t)(bins >> 8);
+    for (int i = 0; i < bins; i++) {
+        uint16_t value = (uint16_t)elevations[i];
+        buffer[6 + 2 * i] = (uint8_t)(value & 0xFF);
+        buffer[7 + 2 * i] = (uint8_t)(value >> 8);
+    }
+    return fileSize(bins);
+}
@@ -0,0 +1,48 @@
+#ifndef HORIZON_PROFILE_H
+#define HORIZON_PROFILE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Per-site horizon: the minimum visible elevation as a function of azimuth.
+//
+// Elevations are sampled at evenly spaced azimuths (bin i sits at
+// i * 360 / binCount() degrees, clockwise from north) and interpolated
+// linearly in between, so lookup is O(1).
+//
+// File format (little-endian, 6 + 2 * bins bytes):
+//   "HZN1"        magic
+//   uint16        bin count (1 to MAX_BINS)
+//   int16[bins]   elevation in hundredths of a degree
+class HorizonProfile {
+private:
+    std::vector<int16_t> elevations; // hundredths of a degree
+    int16_t lowest;
+    int16_t highest;
+
+    void updateLimits();
+
+public:
+    static constexpr int MAX_BINS = 3600;
+
+    // Constructors - flat horizon at 0 degrees
+    HorizonProfile();
+    explicit HorizonProfile(int bins);
+
+    // Profile access
+    int binCount() const { return (int)elevations.size(); }
+    void setElevation(int bin, double degrees);
+    double elevation(int bin) const;
+    double elevationAt(double azimuth) const;
+    double minElevation() const { return lowest / 100.0; }
+    double maxElevation() const { return highest / 100.0; }
+
+    // Compact file format
+    static size_t fileSize(int bins) { return 6 + 2 * (size_t)bins; }
+    bool load(const uint8_t* data, size_t length);
+    bool loadFile(const char* path);
+    size_t save(uint8_t* buffer, size_t capacity) const;
+};
+
+#endif
@@ -0,0 +1,77 @@
+#include "MoonRenderCache.h"
+#include <cmath>
+#include <cstring>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+// Constructor - renders every frame up front
+MoonRenderCache::MoonRenderCache(int diameter, int phaseSteps)
+    : size(diameter > 0 ? diameter : 1), steps(phaseSteps > 0 ? phaseSteps : 1) {
+
+    rowBytes = (size + 7) / 8;
+    frames = new uint8_t[memoryUsage()];
+
+    for (int i = 0; i < steps; i++) {
+        render(360.0 * i / steps, size, frames + frameSize() * i);
+    }
+}
+
+MoonRenderCache::~MoonRenderCache() {
+    delete[] frames;
+}
+
+// Nearest frame for a phase angle in degrees
+int MoonRenderCache::frameIndex(double phaseAngle) const {
+    double position = fmod(phaseAngle / 360.0, 1.0);
+    if (position < 0) position += 1.0;
+    return (int)(position * steps + 0.5) % steps;
+}
+
+// Nearest frame for a BAM phase angle (2^32 == 360 degrees)
+int MoonRenderCache::frameIndexForAngle(uint32_t phaseAngle) const {
+    return (int)((((uint64_t)phaseAngle * steps) + (1ULL << 31)) >> 32) % steps;
+}
+
+const uint8_t* MoonRenderCache::frame(int index) const {
+    if (index < 0 || index >= steps) return nullptr;
+    return frames + frameSize() * index;
+}
+
+// Copy the cached frame for a phase angle
+void MoonRenderCache::draw(double phaseAngle, uint8_t* dest) const {
+    memcpy(dest, frame(frameIndex(phaseAngle)), frameSize());
+}
+
+// Rasterize the lit part of the disk. Per row the disk spans |u| <= w and
+// the terminator is the half-ellipse u = cos(phase) * w; waxing lights the
+// side right of it, waning the side left of its mirror image.
+void MoonRenderCache::render(double phaseAngle, int diameter, uint8_t* dest) {
+    size_t rowBytes = (diameter + 7) / 8;
+    memset(dest, 0, rowBytes * diameter);
+
+    double angle = fmod(phaseAngle, 360.0);
+    if (angle < 0) angle += 360.0;
+    double k = cos(angle * M_PI / 180.0);
+    bool waxing = angle < 180.0;
+    double radius = diameter / 2.0;
+
+    for (int y = 0; y < diameter; y++) {
+        // Pixel centres, normalized to the unit disk
+        double v = (y + 0.5 - radius) / radius;
+        if (v * v >= 1.0) continue;
+        double w = sqrt(1.0 - v * v);
+
+        double litLeft = waxing ? k * w : -w;
+        double litRight = waxing ? w : -k * w;
+
+        uint8_t* row = dest + rowBytes * y;
+        for (int x = 0; x < diameter; x++) {
+            double u = (x + 0.5 - radius) / radius;
+            if (u >= litLeft && u <= litRight) {
+                row[x >> 3] |= (uint8_t)(0x80 >> (x & 7));
+            }
+        }
+    }
+}
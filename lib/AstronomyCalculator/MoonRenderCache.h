@@ -0,0 +1,52 @@
+#ifndef MOON_RENDER_CACHE_H
+#define MOON_RENDER_CACHE_H
+
+#include <cstddef>
+#include <cstdint>
+
+// Pre-rasterized moon-disk bitmaps, one per quantized phase angle.
+//
+// All frames are rendered once by the constructor into a single allocation;
+// drawing afterwards is a lookup plus memcpy. Frames are 1 bit per pixel,
+// MSB first, each row padded to a whole byte (the layout drawBitmap() in
+// Adafruit GFX and most e-ink libraries expect). A set bit is a lit pixel.
+//
+// Phase angles follow AstronomyCalculator::moonPhaseAngle(): 0 = new,
+// 180 = full, waxing below 180 (lit limb on the right, as seen from the
+// northern hemisphere).
+class MoonRenderCache {
+private:
+    int size;
+    int steps;
+    size_t rowBytes;
+    uint8_t* frames;
+
+public:
+    // Constructor - diameter in pixels, phaseSteps frames per lunar cycle
+    MoonRenderCache(int diameter, int phaseSteps);
+    ~MoonRenderCache();
+
+    MoonRenderCache(const MoonRenderCache&) = delete;
+    MoonRenderCache& operator=(const MoonRenderCache&) = delete;
+
+    // Geometry and memory footprint
+    int diameter() const { return size; }
+    int phaseSteps() const { return steps; }
+    size_t bytesPerRow() const { return rowBytes; }
+    size_t frameSize() const { return rowBytes * size; }
+    size_t memoryUsage() const { return frameSize() * steps; }
+
+    // Frame lookup by phase angle in degrees, or as a BAM angle
+    // (AstronomyCalculatorFixed::moonPhaseAngle()) without floating point
+    int frameIndex(double phaseAngle) const;
+    int frameIndexForAngle(uint32_t phaseAngle) const;
+    const uint8_t* frame(int index) const;
+
+    // Copy the frame for a phase angle into dest (frameSize() bytes)
+    void draw(double phaseAngle, uint8_t* dest) const;
+
+    // Uncached per-pixel terminator rendering (what the cache precomputes)
+    static void render(double phaseAngle, int diameter, uint8_t* dest);
+};
+
+#endif
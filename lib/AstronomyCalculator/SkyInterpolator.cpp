@@ -0,0 +1,211 @@
+#include "SkyInterpolator.h"
+#include <cmath>
+
+namespace {
+
+// Channels 1 and 3 are azimuths and wrap at 360 degrees
+bool isAzimuth(int channel) {
+    return channel == 1 || channel == 3;
+}
+
+// Signed azimuth difference folded into [-180, 180)
+double wrapDifference(double difference) {
+    difference = fmod(difference + 180.0, 360.0);
+    if (difference < 0) difference += 360.0;
+    return difference - 180.0;
+}
+
+float evaluateCubic(const float* c, float u) {
+    return c[0] + u * (c[1] + u * (c[2] + u * c[3]));
+}
+
+// Monotonized central difference: the central slope unless it exceeds twice
+// a one-sided one, zero at an extremum. A jump on one side of the keyframe
+// leaves the slope from the other side instead of leaking into both segments.
+double limitedSlope(double backward, double forward) {
+    if (backward * forward <= 0.0) return 0.0;
+    double central = (backward + forward) / 2.0;
+    double limit = 2.0 * std::min(fabs(backward), fabs(forward));
+    return fabs(central) <= limit ? central : (central > 0.0 ? limit : -limit);
+}
+
+// Fritsch-Carlson: scale end tangents (in units of the segment) so the
+// cubic stays monotone between its ends and cannot overshoot either of them
+void limitToSecant(double secant, double* m0, double* m1) {
+    if (secant == 0.0 || *m0 * secant < 0.0) *m0 = 0.0;
+    if (secant == 0.0 || *m1 * secant < 0.0) *m1 = 0.0;
+    if (secant == 0.0) return;
+    double a = *m0 / secant, b = *m1 / secant;
+    double length = a * a + b * b;
+    if (length > 9.0) {
+        double scale = 3.0 / sqrt(length);
+        *m0 *= scale;
+        *m1 *= scale;
+    }
+}
+
+// A one-second azimuth change this large is a jump in the model, not motion
+const double AZIMUTH_JUMP = 90.0;
+
+}
+
+// Constructor - computes the first keyframe and fills the ring
+SkyInterpolator::SkyInterpolator(double lat, double lng, time_t start, int keyframeSeconds, double maxErrorDegrees)
+    : calculator(lat, lng, start),
+      keyframeInterval(keyframeSeconds > 1 ? keyframeSeconds : 1),
+      maxError(maxErrorDegrees),
+      nextStart(start),
+      head(0),
+      tail(0) {
+
+    computeKeyframe(nextStart, &nextKeyframe);
+    while (refresh()) {
+    }
+}
+
+// Exact positions from the full model
+void SkyInterpolator::evaluate(int64_t unixTime, double* values) {
+    values[0] = calculator.sunAltitudeAt((time_t)unixTime, &values[1]);
+    values[2] = calculator.moonAltitudeAt((time_t)unixTime, &values[3]);
+}
+
+// Value plus limited derivative at a keyframe time
+void SkyInterpolator::computeKeyframe(int64_t unixTime, Keyframe* keyframe) {
+    double before[4], after[4];
+    evaluate(unixTime, keyframe->value);
+    evaluate(unixTime - 1, before);
+    evaluate(unixTime + 1, after);
+
+    for (int channel = 0; channel < 4; channel++) {
+        double backward = keyframe->value[channel] - before[channel];
+        double forward = after[channel] - keyframe->value[channel];
+        if (isAzimuth(channel)) {
+            backward = wrapDifference(backward);
+            forward = wrapDifference(forward);
+        }
+        keyframe->derivative[channel] = limitedSlope(backward, forward);
+    }
+}
+
+// Fit the next segment, halving it until the quarter-point errors are within budget
+void SkyInterpolator::buildSegment(Segment* segment) {
+    int32_t duration = keyframeInterval;
+    Keyframe end;
+
+    for (;;) {
+        computeKeyframe(nextStart + duration, &end);
+
+        for (int channel = 0; channel < 4; channel++) {
+            double p0 = nextKeyframe.value[channel];
+            double p1 = end.value[channel];
+            if (isAzimuth(channel)) p1 = p0 + wrapDifference(p1 - p0);
+            double m0 = nextKeyframe.derivative[channel] * duration;
+            double m1 = end.derivative[channel] * duration;
+
+            float* c = segment->coefficient[channel];
+            c[0] = (float)p0;
+            if (duration == 1) {
+                // Linear, so nothing overshoots the exact ends; a jump in
+                // the model holds the earlier side rather than sweeping
+                // through directions the model never takes
+                bool jump = isAzimuth(channel) && fabs(p1 - p0) >= AZIMUTH_JUMP;
+                c[1] = jump ? 0.0f : (float)(p1 - p0);
+                c[2] = c[3] = 0.0f;
+                continue;
+            }
+            limitToSecant(p1 - p0, &m0, &m1);
+            c[1] = (float)m0;
+            c[2] = (float)(3.0 * (p1 - p0) - 2.0 * m0 - m1);
+            c[3] = (float)(2.0 * (p0 - p1) + m0 + m1);
+        }
+
+        // One-second segments have exact ends and cannot be split further
+        if (duration == 1) break;
+
+        int32_t half = duration / 2;
+        double worst = 0.0;
+        for (int quarter = 1; quarter <= 3; quarter++) {
+            int32_t offset = duration * quarter / 4;
+            if (offset == 0) continue;
+            double exact[4];
+            evaluate(nextStart + offset, exact);
+            float u = (float)offset / duration;
+
+            for (int channel = 0; channel < 4; channel++) {
+                double error = evaluateCubic(segment->coefficient[channel], u) - exact[channel];
+                if (isAzimuth(channel)) error = wrapDifference(error);
+                worst = std::max(worst, fabs(error));
+            }
+        }
+        if (worst <= maxError / 2.0) break;
+
+        duration = half;
+    }
+
+    segment->start = nextStart;
+    segment->duration = duration;
+    nextStart += duration;
+    nextKeyframe = end;
+}
+
+// Producer: append one segment if the consumer has released a slot
+bool SkyInterpolator::refresh() {
+    uint32_t h = head.load(std::memory_order_relaxed);
+    uint32_t t = tail.load(std::memory_order_acquire);
+    if (h - t >= (uint32_t)CAPACITY) return false;
+
+    buildSegment(&segments[h % CAPACITY]);
+    head.store(h + 1, std::memory_order_release);
+    return true;
+}
+
+// Consumer: evaluate the segment covering unixMillis
+bool SkyInterpolator::sample(int64_t unixMillis, SkyPosition* position) {
+    uint32_t t = tail.load(std::memory_order_relaxed);
+    uint32_t h = head.load(std::memory_order_acquire);
+
+    while (t != h) {
+        const Segment& segment = segments[t % CAPACITY];
+        int64_t startMillis = segment.start * 1000;
+        if (unixMillis < startMillis) return false;
+
+        int64_t offset = unixMillis - startMillis;
+        if (offset < (int64_t)segment.duration * 1000) {
+            float u = (float)offset / (segment.duration * 1000.0f);
+            float values[4];
+            for (int channel = 0; channel < 4; channel++) {
+                values[channel] = evaluateCubic(segment.coefficient[channel], u);
+                if (isAzimuth(channel)) {
+                    if (values[channel] >= 360.0f) values[channel] -= 360.0f;
+                    if (values[channel] < 0.0f) values[channel] += 360.0f;
+                }
+            }
+            position->sunAltitude = values[0];
+            position->sunAzimuth = values[1];
+            position->moonAltitude = values[2];
+            position->moonAzimuth = values[3];
+            return true;
+        }
+
+        // Segment is in the past; hand its slot back to the producer
+        t++;
+        tail.store(t, std::memory_order_release);
+    }
+    return false;
+}
+
+// Start of the oldest buffered segment, or 0 when nothing is buffered
+int64_t SkyInterpolator::bufferedStart() const {
+    uint32_t t = tail.load(std::memory_order_acquire);
+    uint32_t h = head.load(std::memory_order_acquire);
+    return (t == h) ? 0 : segments[t % CAPACITY].start;
+}
+
+// End of the newest buffered segment, or 0 when nothing is buffered
+int64_t SkyInterpolator::bufferedEnd() const {
+    uint32_t t = tail.load(std::memory_order_acquire);
+    uint32_t h = head.load(std::memory_order_acquire);
+    if (t == h) return 0;
+    const Segment& segment = segments[(h - 1) % CAPACITY];
+    return segment.start + segment.duration;
+}
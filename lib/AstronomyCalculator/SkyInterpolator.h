@@ -0,0 +1,87 @@
+#ifndef SKY_INTERPOLATOR_H
+#define SKY_INTERPOLATOR_H
+
+#include <atomic>
+#include <cstdint>
+#include <ctime>
+#include "AstronomyCalculator.h"
+
+// Sun and moon altitude/azimuth for one frame, in degrees
+struct SkyPosition {
+    float sunAltitude;
+    float sunAzimuth;
+    float moonAltitude;
+    float moonAzimuth;
+};
+
+// Per-frame sky positions from cubic Hermite segments between exact keyframes.
+//
+// Keyframes come from AstronomyCalculator::sunAltitudeAt()/moonAltitudeAt()
+// with central-difference derivatives, limited so that a jump on one side
+// of a keyframe doesn't leak into the slope on the other. End tangents are
+// limited again per segment (Fritsch-Carlson) so each cubic is monotone and
+// stays between its exact ends at every frame time, not only at whole
+// seconds. Each new segment is checked against the exact model at its
+// quarter points (the Hermite error term u^2 (1 - u)^2 peaks at the
+// midpoint; the outer two catch kinks such as the clamped sun azimuth near
+// lower transit) and halved until those errors are at most half of
+// maxErrorDegrees, leaving the other half as margin. Discontinuities in the
+// model shrink segments down to one second; those are linear, and an
+// azimuth jump holds its earlier value until the next whole second.
+//
+// Segments live in a fixed ring with a single producer (refresh(), which
+// does the expensive work) and a single consumer (sample(), a few float
+// multiply-adds per channel). The two may run on different tasks/threads.
+class SkyInterpolator {
+public:
+    static constexpr int CAPACITY = 32; // segments buffered ahead
+
+private:
+    struct Keyframe {
+        double value[4];      // sun alt, sun az, moon alt, moon az
+        double derivative[4]; // degrees per second
+    };
+
+    struct Segment {
+        int64_t start;       // Unix seconds
+        int32_t duration;    // seconds
+        float coefficient[4][4]; // per channel: a + b u + c u^2 + d u^3
+    };
+
+    AstronomyCalculator calculator;
+    int keyframeInterval;
+    double maxError;
+
+    // Producer state
+    int64_t nextStart;
+    Keyframe nextKeyframe;
+
+    Segment segments[CAPACITY];
+    std::atomic<uint32_t> head; // next slot the producer fills
+    std::atomic<uint32_t> tail; // oldest slot the consumer still needs
+
+    void evaluate(int64_t unixTime, double* values);
+    void computeKeyframe(int64_t unixTime, Keyframe* keyframe);
+    void buildSegment(Segment* segment);
+
+public:
+    // Constructor - fills the ring starting at start
+    SkyInterpolator(double lat, double lng, time_t start, int keyframeSeconds = 300, double maxErrorDegrees = 0.01);
+
+    SkyInterpolator(const SkyInterpolator&) = delete;
+    SkyInterpolator& operator=(const SkyInterpolator&) = delete;
+
+    // Producer: add one segment if there is room; returns false when full
+    bool refresh();
+
+    // Consumer: interpolated positions at a time in Unix milliseconds.
+    // Segments wholly before unixMillis are released for refresh(). Returns
+    // false if unixMillis is outside the buffered window.
+    bool sample(int64_t unixMillis, SkyPosition* position);
+
+    // Buffered window, Unix seconds
+    int64_t bufferedStart() const;
+    int64_t bufferedEnd() const;
+};
+
+#endif
@@ -0,0 +1,383 @@
+// Native batch tool: reads query records from stdin or a file and streams
+// results as CSV or NDJSON. Built by [env:native]; see README "Batch Tool".
+//
+// Input, one query per line (format detected from the first record):
+//   NDJSON  {"lat":40.7128,"lng":-74.006,"time":1781524800}
+//           {"lat":40.7128,"lng":-74.006,"from":"2026-01-01","to":"2026-12-31","step":86400}
+//   CSV     lat,lng,time
+//           lat,lng,from,to[,step]
+// Times are Unix seconds, YYYY-MM-DD (local noon) or YYYY-MM-DDTHH:MM[:SS][Z];
+// lines are parsed by AstronomyQueryParser (AstronomyQuery.h).
+//
+// Memory stays bounded whatever the input size: lines are read through a
+// fixed buffer, date ranges expand lazily, and results are computed and
+// written one batch at a time.
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <memory>
+#include <thread>
+#include <vector>
+#include "AstronomyCache.h"
+#include "AstronomyCalculator.h"
+#include "AstronomyQuery.h"
+#include "AstronomySerializer.h"
+
+namespace {
+
+const size_t IO_BUFFER_SIZE = 1 << 20;
+const size_t MAX_LINE = 64 * 1024;
+const size_t BATCH_SIZE = 8192;
+const size_t PREFIX_MAX = 96; // lat, lng and time columns
+const int MAX_WARNINGS = 10;
+
+enum Format { FORMAT_AUTO, FORMAT_CSV, FORMAT_NDJSON };
+
+struct Options {
+    const char* inputPath = nullptr;
+    const char* outputPath = nullptr;
+    Format inputFormat = FORMAT_AUTO;
+    Format outputFormat = FORMAT_AUTO;
+    int threads = 1;
+    size_t cacheEntries = 0;
+    bool header = true;
+    bool quiet = false;
+};
+
+// One calculation to run
+struct WorkItem {
+    double lat;
+    double lng;
+    time_t time;
+};
+
+// Reads lines through a fixed buffer; longer lines are skipped and reported
+class LineReader {
+public:
+    explicit LineReader(FILE* file) : file(file), buffer(IO_BUFFER_SIZE), start(0), end(0), eof(false) {}
+
+    // Returns false at end of input; *tooLong is set for skipped lines
+    bool next(const char** line, size_t* length, bool* tooLong) {
+        *tooLong = false;
+        for (;;) {
+            char* newline = (char*)memchr(buffer.data() + start, '\n', end - start);
+            if (newline != nullptr) {
+                *line = buffer.data() + start;
+                *length = newline - *line;
+                start = newline - buffer.data() + 1;
+                if (*length > 0 && (*line)[*length - 1] == '\r') (*length)--;
+                return true;
+            }
+
+            if (eof) {
+                if (start == end) return false;
+                *line = buffer.data() + start;
+                *length = end - start;
+                start = end;
+                return true;
+            }
+
+            // Keep the partial line and refill behind it
+            if (start > 0) {
+                memmove(buffer.data(), buffer.data() + start, end - start);
+                end -= start;
+                start = 0;
+            }
+            if (end - start >= MAX_LINE) {
+                // Drop the oversized line up to its newline
+                *tooLong = true;
+                end = start = 0;
+                skipToNewline();
+                *line = buffer.data();
+                *length = 0;
+                return true;
+            }
+
+            size_t n = fread(buffer.data() + end, 1, buffer.size() - end, file);
+            if (n == 0) eof = true;
+            end += n;
+        }
+    }
+
+private:
+    FILE* file;
+    std::vector<char> buffer;
+    size_t start;
+    size_t end;
+    bool eof;
+
+    void skipToNewline() {
+        for (;;) {
+            size_t n = fread(buffer.data(), 1, buffer.size(), file);
+            if (n == 0) {
+                eof = true;
+                return;
+            }
+            char* newline = (char*)memchr(buffer.data(), '\n', n);
+            if (newline != nullptr) {
+                start = newline - buffer.data() + 1;
+                end = n;
+                return;
+            }
+        }
+    }
+};
+
+// Formats one result row into out; returns bytes written
+size_t formatRow(const WorkItem& item, const AstronomyRecord& record, Format format, char* out) {
+    size_t used;
+    if (format == FORMAT_CSV) {
+        used = snprintf(out, PREFIX_MAX, "%.6f,%.6f,%lld,", item.lat, item.lng, (long long)item.time);
+        used += AstronomySerializer::writeCsv(record, out + used, AstronomySerializer::CSV_MAX_SIZE);
+    } else {
+        // Prefix without a trailing comma; the record's '{' becomes the separator
+        used = snprintf(out, PREFIX_MAX, "{\"lat\":%.6f,\"lng\":%.6f,\"time\":%lld",
+                        item.lat, item.lng, (long long)item.time);
+        size_t json = AstronomySerializer::writeJson(record, out + used, AstronomySerializer::JSON_MAX_SIZE);
+        out[used] = ',';
+        used += json;
+    }
+    out[used++] = '\n';
+    return used;
+}
+
+size_t rowCapacity(Format format) {
+    return PREFIX_MAX + 1 + (format == FORMAT_CSV ? AstronomySerializer::CSV_MAX_SIZE : AstronomySerializer::JSON_MAX_SIZE);
+}
+
+// Computes and formats items[first, last) into out
+void processRange(const WorkItem* items, size_t first, size_t last, Format format,
+                  AstronomyCache* cache, std::vector<char>* out) {
+    out->resize((last - first) * rowCapacity(format));
+    char* p = out->data();
+    for (size_t i = first; i < last; i++) {
+        const WorkItem& item = items[i];
+        AstronomyRecord record = cache ? cache->lookup(item.lat, item.lng, item.time)
+                                       : AstronomyRecord(AstronomyCalculator(item.lat, item.lng, item.time));
+        p += formatRow(item, record, format, p);
+    }
+    out->resize(p - out->data());
+}
+
+void usage(FILE* stream) {
+    fprintf(stream,
+            "Usage: astronomy-batch [options] [input]\n"
+            "Reads queries (CSV or NDJSON, one per line) from input or stdin and writes results.\n"
+            "\n"
+            "  -o, --output FILE       write results to FILE instead of stdout\n"
+            "  -f, --format csv|ndjson output format (default: same as input)\n"
+            "      --input-format csv|ndjson\n"
+            "                          input format (default: detect from first record)\n"
+            "  -j, --threads N         worker threads, 0 = one per core (default 1)\n"
+            "      --cache N           reuse per-day results for up to N locations/dates;\n"
+            "                          output is identical, only faster for repeats\n"
+            "      --no-header         omit the CSV header row\n"
+            "  -q, --quiet             no throughput report on stderr\n"
+            "  -h, --help              show this help\n");
+}
+
+bool parseFormat(const char* text, Format* format) {
+    if (strcmp(text, "csv") == 0) *format = FORMAT_CSV;
+    else if (strcmp(text, "ndjson") == 0 || strcmp(text, "json") == 0) *format = FORMAT_NDJSON;
+    else return false;
+    return true;
+}
+
+bool parseOptions(int argc, char** argv, Options* options) {
+    for (int i = 1; i < argc; i++) {
+        const char* arg = argv[i];
+        const char* value = (i + 1 < argc) ? argv[i + 1] : nullptr;
+        auto is = [&](const char* shortName, const char* longName) {
+            return (shortName && strcmp(arg, shortName) == 0) || strcmp(arg, longName) == 0;
+        };
+
+        if (is("-h", "--help")) {
+            usage(stdout);
+            exit(0);
+        } else if (is("-q", "--quiet")) {
+            options->quiet = true;
+        } else if (is(nullptr, "--no-header")) {
+            options->header = false;
+        } else if (is("-o", "--output") && value) {
+            options->outputPath = argv[++i];
+        } else if (is("-f", "--format") && value) {
+            if (!parseFormat(argv[++i], &options->outputFormat)) return false;
+        } else if (is(nullptr, "--input-format") && value) {
+            if (!parseFormat(argv[++i], &options->inputFormat)) return false;
+        } else if (is("-j", "--threads") && value) {
+            options->threads = atoi(argv[++i]);
+            if (options->threads <= 0) options->threads = std::max(1u, std::thread::hardware_concurrency());
+        } else if (is(nullptr, "--cache") && value) {
+            options->cacheEntries = strtoul(argv[++i], nullptr, 10);
+        } else if (arg[0] == '-' && arg[1] != '\0') {
+            return false;
+        } else if (options->inputPath == nullptr) {
+            options->inputPath = arg;
+        } else {
+            return false;
+        }
+    }
+    return true;
+}
+
+}
+
+int main(int argc, char** argv) {
+    Options options;
+    if (!parseOptions(argc, argv, &options)) {
+        usage(stderr);
+        return 64;
+    }
+
+    FILE* input = stdin;
+    if (options.inputPath != nullptr && strcmp(options.inputPath, "-") != 0) {
+        input = fopen(options.inputPath, "rb");
+        if (input == nullptr) {
+            fprintf(stderr, "astronomy-batch: cannot open %s\n", options.inputPath);
+            return 66;
+        }
+    }
+    FILE* output = stdout;
+    if (options.outputPath != nullptr) {
+        output = fopen(options.outputPath, "wb");
+        if (output == nullptr) {
+            fprintf(stderr, "astronomy-batch: cannot create %s\n", options.outputPath);
+            return 73;
+        }
+    }
+    setvbuf(output, nullptr, _IOFBF, IO_BUFFER_SIZE);
+
+    std::unique_ptr<AstronomyCache> cache;
+    if (options.cacheEntries > 0) {
+        // Exact coordinates, so cached output is byte-identical to uncached
+        cache.reset(new AstronomyCache(options.cacheEntries, 0.0, std::max(16, options.threads * 4)));
+    }
+
+    LineReader reader(input);
+    std::vector<WorkItem> batch;
+    batch.reserve(BATCH_SIZE);
+    std::vector<std::vector<char>> outputs(options.threads);
+    Format inputFormat = options.inputFormat;
+    Format outputFormat = options.outputFormat;
+
+    AstronomyQuery pending = {};
+    int64_t pendingNext = 1;
+    bool havePending = false;
+    uint64_t lineNumber = 0, linesRead = 0, rejected = 0, results = 0, bytesOut = 0;
+    bool done = false, writeFailed = false, headerSeen = false;
+    auto begin = std::chrono::steady_clock::now();
+
+    while (!done && !writeFailed) {
+        // Fill a batch, expanding ranges lazily
+        batch.clear();
+        while (batch.size() < BATCH_SIZE) {
+            if (havePending) {
+                batch.push_back({ pending.lat, pending.lng, (time_t)pendingNext });
+                if (pending.to - pendingNext < pending.step) havePending = false;
+                else pendingNext += pending.step;
+                continue;
+            }
+
+            const char* line;
+            size_t length;
+            bool tooLong;
+            if (!reader.next(&line, &length, &tooLong)) {
+                done = true;
+                break;
+            }
+            lineNumber++;
+
+            size_t first = 0;
+            while (first < length && (line[first] == ' ' || line[first] == '\t')) first++;
+            if (!tooLong && first == length) continue;
+            linesRead++;
+
+            if (inputFormat == FORMAT_AUTO && !tooLong) {
+                inputFormat = (line[first] == '{') ? FORMAT_NDJSON : FORMAT_CSV;
+            }
+            if (outputFormat == FORMAT_AUTO && inputFormat != FORMAT_AUTO) {
+                outputFormat = inputFormat;
+            }
+
+            bool ok = !tooLong && (inputFormat == FORMAT_NDJSON ? AstronomyQueryParser::parseNdjson(line, length, &pending)
+                                                                : AstronomyQueryParser::parseCsv(line, length, &pending));
+            if (!ok) {
+                // A single leading CSV header is expected, not an error
+                bool header = inputFormat == FORMAT_CSV && linesRead == 1 && !headerSeen && !tooLong &&
+                              !(line[first] == '-' || line[first] == '.' || (line[first] >= '0' && line[first] <= '9'));
+                if (header) {
+                    headerSeen = true;
+                    continue;
+                }
+                if (rejected < MAX_WARNINGS) {
+                    fprintf(stderr, "astronomy-batch: line %llu: %s\n", (unsigned long long)lineNumber,
+                            tooLong ? "line too long" : "malformed query");
+                }
+                rejected++;
+                continue;
+            }
+            havePending = true;
+            pendingNext = pending.from;
+        }
+
+        if (outputFormat == FORMAT_AUTO) outputFormat = FORMAT_NDJSON;
+        if (options.header && outputFormat == FORMAT_CSV && bytesOut == 0 && (!batch.empty() || done)) {
+            char header[AstronomySerializer::JSON_MAX_SIZE];
+            AstronomySerializer::writeCsvHeader(header, sizeof(header));
+            bytesOut += fprintf(output, "lat,lng,time,%s\n", header);
+        }
+        if (batch.empty()) continue;
+
+        // Split the batch into contiguous slices, one per thread
+        size_t workers = std::min((size_t)options.threads, batch.size());
+        size_t slice = (batch.size() + workers - 1) / workers;
+        if (workers == 1) {
+            processRange(batch.data(), 0, batch.size(), outputFormat, cache.get(), &outputs[0]);
+        } else {
+            std::vector<std::thread> threads;
+            for (size_t w = 0; w < workers; w++) {
+                size_t first = w * slice, last = std::min(batch.size(), first + slice);
+                threads.emplace_back(processRange, batch.data(), first, last, outputFormat, cache.get(), &outputs[w]);
+            }
+            for (auto& thread : threads) thread.join();
+        }
+
+        for (size_t w = 0; w < workers; w++) {
+            if (fwrite(outputs[w].data(), 1, outputs[w].size(), output) != outputs[w].size()) {
+                writeFailed = true;
+                break;
+            }
+            bytesOut += outputs[w].size();
+        }
+        results += batch.size();
+    }
+
+    if (fflush(output) != 0) writeFailed = true;
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+    if (input != stdin) fclose(input);
+    if (output != stdout && fclose(output) != 0) writeFailed = true;
+
+    if (writeFailed) {
+        fprintf(stderr, "astronomy-batch: write failed\n");
+        return 74;
+    }
+
+    if (!options.quiet) {
+        fprintf(stderr, "astronomy-batch: %llu queries, %llu results, %llu rejected in %.3f s "
+                        "(%.0f results/s, %.1f MB/s out, %d thread%s",
+                (unsigned long long)(linesRead - headerSeen - rejected), (unsigned long long)results,
+                (unsigned long long)rejected, seconds, seconds > 0 ? results / seconds : 0.0,
+                seconds > 0 ? bytesOut / seconds / 1e6 : 0.0, options.threads, options.threads == 1 ? "" : "s");
+        if (cache) {
+            AstronomyCache::Stats stats = cache->stats();
+            uint64_t lookups = stats.hits + stats.misses;
+            fprintf(stderr, ", cache %.1f%% hits", lookups ? 100.0 * stats.hits / lookups : 0.0);
+        }
+        fprintf(stderr, ")\n");
+    }
+    return rejected > 0 ? 65 : 0;
+}
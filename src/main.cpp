@@ -2,6 +2,7 @@
 #include <WiFi.h>
 #include <time.h>
 #include "AstronomyCalculator.h"
+#include "AstronomySerializer.h"
 
 // WiFi credentials
 const char* ssid = "YOUR_WIFI_SSID";
@@ -61,6 +62,12 @@ void loop() {
         Serial.println("Moon is not currently visible");
     }
     
+    // Machine-readable copy of every field
+    char json[AstronomySerializer::JSON_MAX_SIZE];
+    if (AstronomySerializer::writeJson(AstronomyRecord(astro), json, sizeof(json)) > 0) {
+        Serial.println(json);
+    }
+    
     // Wait 1 hour before next calculation
     delay(3600000);
 }
\ No newline at end of file
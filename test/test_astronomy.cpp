@@ -5,7 +5,20 @@
 #include <string>
 #include <vector>
 #include <iomanip>
+#include <chrono>
 #include "AstronomyCalculator.h"
+#include "AstronomyCalculatorFixed.h"
+#include "AstronomySerializer.h"
+#include "MoonRenderCache.h"
+#include "HorizonProfile.h"
+#include "SkyInterpolator.h"
+#include "AstronomyCache.h"
+#include "AstronomyQuery.h"
+#include <cstdio>
+#include <cstring>
+#include <climits>
+#include <thread>
+#include <atomic>
 
 class AstronomyTest {
 private:
@@ -97,6 +110,27 @@ private:
         return std::abs(actual - expected) <= toleranceMinutes;
     }
 
+    // Like timeWithinTolerance, but both empty counts as a match and the
+    // comparison wraps around midnight
+    bool clockWithinTolerance(const std::string& actual, const std::string& expected, int toleranceMinutes) {
+        if (actual.empty() || expected.empty()) return actual.empty() && expected.empty();
+
+        int actualTotalMin = std::stoi(actual.substr(0, 2)) * 60 + std::stoi(actual.substr(2, 2));
+        int expectedTotalMin = std::stoi(expected.substr(0, 2)) * 60 + std::stoi(expected.substr(2, 2));
+        int diff = std::abs(actualTotalMin - expectedTotalMin);
+        return std::min(diff, 1440 - diff) <= toleranceMinutes;
+    }
+
+    int clockMinutes(const std::string& hhmm) {
+        if (hhmm.empty()) return -1;
+        return std::stoi(hhmm.substr(0, 2)) * 60 + std::stoi(hhmm.substr(2, 2));
+    }
+
+    bool bearingWithinTolerance(double actual, double expected, double toleranceDegrees) {
+        double diff = std::fmod(std::abs(actual - expected), 360.0);
+        return std::min(diff, 360.0 - diff) <= toleranceDegrees;
+    }
+
 public:
     AstronomyTest() {
         // Initialize test dates
@@ -139,6 +173,42 @@ public:
         totalTests++;
         if (testConsistencyChecks()) passedTests++;
 
+        totalTests++;
+        if (testDayEventsIndependentOfTimeOfDay()) passedTests++;
+
+        totalTests++;
+        if (testFixedPointParity()) passedTests++;
+
+        totalTests++;
+        if (testSerializerRoundTrip()) passedTests++;
+
+        totalTests++;
+        if (testMoonIllumination()) passedTests++;
+
+        totalTests++;
+        if (testMoonRenderCache()) passedTests++;
+
+        totalTests++;
+        if (testHorizonProfile()) passedTests++;
+
+        totalTests++;
+        if (testSkyInterpolator()) passedTests++;
+
+        totalTests++;
+        if (testAstronomyCache()) passedTests++;
+
+        totalTests++;
+        if (testQueryParser()) passedTests++;
+
+        // Benchmarks are informational and do not count towards the summary
+        std::cout << "=== Performance Benchmarks ===" << std::endl;
+        benchmarkFixedPoint();
+        benchmarkSerializer();
+        benchmarkMoonRenderCache();
+        benchmarkHorizonProfile();
+        benchmarkSkyInterpolator();
+        benchmarkAstronomyCache();
+
         // Print summary
         std::cout << "=== Test Summary ===" << std::endl;
         std::cout << "Passed: " << passedTests << "/" << totalTests << " tests" << std::endl;
@@ -268,6 +338,1084 @@ private:
         std::cout << "  ✅ Internal consistency checks passed" << std::endl;
         return true;
     }
+
+    bool testDayEventsIndependentOfTimeOfDay() {
+        std::cout << "Testing rise/set independence from time of day..." << std::endl;
+
+        // Offsets from local noon covering the whole local date
+        const int offsets[] = { -12 * 3600, -5 * 3600 - 1800, -1, 0, 6 * 3600 + 2700, 12 * 3600 - 1 };
+        int mismatches = 0;
+
+        for (const auto& location : locations) {
+            for (const auto& date : testDates) {
+                AstronomyCalculator noon(location.latitude, location.longitude, date.timestamp);
+                AstronomyCalculatorFixed fixedNoon(location.latitude, location.longitude, date.timestamp);
+                const AstronomyDayEvents& expected = noon.dayEvents();
+
+                for (int offset : offsets) {
+                    time_t t = date.timestamp + offset;
+                    AstronomyCalculator astro(location.latitude, location.longitude, t);
+                    AstronomyCalculatorFixed fixed(location.latitude, location.longitude, t);
+                    const AstronomyDayEvents& events = astro.dayEvents();
+
+                    bool same = events.sunrise == expected.sunrise && events.sunset == expected.sunset;
+                    for (int day = 0; day < 3; day++) {
+                        same &= events.moonrise[day] == expected.moonrise[day];
+                        same &= events.moonset[day] == expected.moonset[day];
+                    }
+                    same &= astro.sunRiseTodayHHMM == noon.sunRiseTodayHHMM;
+                    same &= astro.sunSetTodayHHMM == noon.sunSetTodayHHMM;
+                    same &= astro.minutesSunVisible == noon.minutesSunVisible;
+                    same &= fixed.sunRiseTodayHHMM == fixedNoon.sunRiseTodayHHMM;
+                    same &= fixed.sunSetTodayHHMM == fixedNoon.sunSetTodayHHMM;
+                    same &= fixed.minutesSunVisible == fixedNoon.minutesSunVisible;
+
+                    if (!same) {
+                        if (mismatches < 3) {
+                            std::cout << "  ❌ " << location.name << " " << date.name << " at noon"
+                                      << (offset < 0 ? "" : "+") << offset << "s: sunrise "
+                                      << astro.sunRiseTodayHHMM << " vs " << noon.sunRiseTodayHHMM
+                                      << ", moonrise " << events.moonrise[1] << " vs " << expected.moonrise[1]
+                                      << std::endl;
+                        }
+                        mismatches++;
+                    }
+                }
+            }
+        }
+
+        if (mismatches > 0) {
+            std::cout << "  ❌ " << mismatches << " instants changed their date's rise/set" << std::endl;
+            return false;
+        }
+        std::cout << "  ✅ Rise/set identical at every time of day" << std::endl;
+        return true;
+    }
+
+    bool testFixedPointParity() {
+        std::cout << "Testing fixed-point backend against double implementation..." << std::endl;
+
+        // Tolerances documented in AstronomyCalculatorFixed.h
+        const int minuteTolerance = 2;
+        const double angleTolerance = 0.05;
+
+        std::vector<TestLocation> sites = locations;
+        sites.push_back({"Sydney", -33.8688, 151.2093});
+        sites.push_back({"Fairbanks", 64.8378, -147.7164});
+        sites.push_back({"Ushuaia", -54.8019, -68.3030});
+
+        int samples = 0;
+        int fieldFailures = 0;
+        int boundaryMismatches = 0;
+        time_t start = createTimestamp(2026, 1, 1);
+
+        for (const auto& site : sites) {
+            for (int day = 0; day < 366; day++) {
+                // Walk the time of day as well so every branch gets exercised
+                time_t t = start + (time_t)day * 86400 + (day * 7919) % 86400;
+                AstronomyCalculator ref(site.latitude, site.longitude, t);
+                AstronomyCalculatorFixed fixed(site.latitude, site.longitude, t);
+                samples++;
+
+                bool ok = true;
+                ok &= std::abs(ref.minutesSinceSunRise - fixed.minutesSinceSunRise) <= minuteTolerance;
+                ok &= std::abs(ref.minutesSinceSunSet - fixed.minutesSinceSunSet) <= minuteTolerance;
+                ok &= std::abs(ref.minutesUntilSunSet - fixed.minutesUntilSunSet) <= minuteTolerance;
+                ok &= std::abs(ref.minutesUntilSunRise - fixed.minutesUntilSunRise) <= minuteTolerance;
+                ok &= std::abs(ref.minutesSunVisible - fixed.minutesSunVisible) <= minuteTolerance;
+                ok &= clockWithinTolerance(fixed.sunRiseTodayHHMM, ref.sunRiseTodayHHMM, minuteTolerance);
+                ok &= clockWithinTolerance(fixed.sunSetTodayHHMM, ref.sunSetTodayHHMM, minuteTolerance);
+                ok &= std::abs(ref.sunAltitudeAtRise - fixed.sunAltitudeAtRise) <= angleTolerance;
+                ok &= bearingWithinTolerance(fixed.sunAzimuthAtRise, ref.sunAzimuthAtRise, angleTolerance);
+
+                // Moon fields depend on discrete choices (visible now, which
+                // rise is "last", which day an event at midnight falls on); a
+                // flip there is a boundary case, not an error
+                auto nearMidnight = [&](const std::string& hhmm) {
+                    int minutes = clockMinutes(hhmm);
+                    return minutes >= 0 && (minutes <= minuteTolerance || minutes >= 1440 - minuteTolerance);
+                };
+                bool midnightEvent = false;
+                for (const std::string* clock : { &ref.nextMoonRiseHHMM, &ref.nextMoonSetHHMM, &ref.lastMoonRiseHHMM,
+                                                  &ref.lastMoonSetHHMM, &fixed.nextMoonRiseHHMM, &fixed.nextMoonSetHHMM,
+                                                  &fixed.lastMoonRiseHHMM, &fixed.lastMoonSetHHMM }) {
+                    midnightEvent |= nearMidnight(*clock);
+                }
+                if (ref.isMoonVisible != fixed.isMoonVisible || ref.moonPhase() != fixed.moonPhase() ||
+                    (ref.minutesSinceLastMoonRise < 0) != (fixed.minutesSinceLastMoonRise < 0) ||
+                    (ref.minutesUntilNextMoonRise < 0) != (fixed.minutesUntilNextMoonRise < 0)) {
+                    boundaryMismatches++;
+                    continue;
+                }
+
+                bool sunOk = ok;
+                ok &= std::abs(ref.minutesSinceLastMoonRise - fixed.minutesSinceLastMoonRise) <= minuteTolerance;
+                ok &= std::abs(ref.minutesSinceLastMoonSet - fixed.minutesSinceLastMoonSet) <= minuteTolerance;
+                ok &= std::abs(ref.minutesUntilNextMoonRise - fixed.minutesUntilNextMoonRise) <= minuteTolerance;
+                ok &= std::abs(ref.minutesUntilNextMoonSet - fixed.minutesUntilNextMoonSet) <= minuteTolerance;
+                ok &= std::abs(ref.minutesMoonVisible - fixed.minutesMoonVisible) <= minuteTolerance;
+                ok &= clockWithinTolerance(fixed.nextMoonRiseHHMM, ref.nextMoonRiseHHMM, minuteTolerance);
+                ok &= clockWithinTolerance(fixed.nextMoonSetHHMM, ref.nextMoonSetHHMM, minuteTolerance);
+                ok &= clockWithinTolerance(fixed.lastMoonRiseHHMM, ref.lastMoonRiseHHMM, minuteTolerance);
+                ok &= clockWithinTolerance(fixed.lastMoonSetHHMM, ref.lastMoonSetHHMM, minuteTolerance);
+                ok &= std::abs(ref.moonAltitudeAtRise - fixed.moonAltitudeAtRise) <= angleTolerance;
+                ok &= bearingWithinTolerance(fixed.moonAzimuthAtRise, ref.moonAzimuthAtRise, angleTolerance);
+                if (!ok && sunOk && midnightEvent) {
+                    boundaryMismatches++;
+                    continue;
+                }
+
+                if (!ok) {
+                    if (fieldFailures < 3) {
+                        std::cout << "  ❌ " << site.name << " day " << day << ": sunrise "
+                                  << ref.sunRiseTodayHHMM << " vs " << fixed.sunRiseTodayHHMM
+                                  << ", moonrise " << ref.nextMoonRiseHHMM << " vs " << fixed.nextMoonRiseHHMM << std::endl;
+                    }
+                    fieldFailures++;
+                }
+            }
+        }
+
+        // Integer-only construction must agree with the double constructor
+        AstronomyCalculatorFixed fromDegrees(40.7128, -74.0060, start);
+        AstronomyCalculatorFixed fromMicro = AstronomyCalculatorFixed::fromMicroDegrees(40712800, -74006000, start);
+        if (fromDegrees.sunRiseTodayHHMM != fromMicro.sunRiseTodayHHMM ||
+            fromDegrees.minutesSunVisible != fromMicro.minutesSunVisible) {
+            std::cout << "  ❌ fromMicroDegrees disagrees with the double constructor" << std::endl;
+            return false;
+        }
+
+        if (fieldFailures > 0 || boundaryMismatches * 500 > samples) {
+            std::cout << "  ❌ " << fieldFailures << " out-of-tolerance and " << boundaryMismatches
+                      << " boundary mismatches in " << samples << " samples" << std::endl;
+            return false;
+        }
+
+        std::cout << "  ✅ Fixed-point matches within tolerance (" << samples << " samples, "
+                  << boundaryMismatches << " boundary cases)" << std::endl;
+        return true;
+    }
+
+    static bool collectChunks(void* context, const char* data, size_t length) {
+        static_cast<std::string*>(context)->append(data, length);
+        return true;
+    }
+
+    bool recordsMatch(const AstronomyRecord& a, const AstronomyRecord& b) {
+        const double angleTolerance = 0.000005;
+        return a.isMoonVisible == b.isMoonVisible &&
+               a.minutesSinceLastMoonRise == b.minutesSinceLastMoonRise &&
+               a.minutesSinceLastMoonSet == b.minutesSinceLastMoonSet &&
+               a.minutesUntilNextMoonRise == b.minutesUntilNextMoonRise &&
+               a.minutesUntilNextMoonSet == b.minutesUntilNextMoonSet &&
+               strcmp(a.nextMoonRiseHHMM, b.nextMoonRiseHHMM) == 0 &&
+               strcmp(a.nextMoonSetHHMM, b.nextMoonSetHHMM) == 0 &&
+               strcmp(a.lastMoonRiseHHMM, b.lastMoonRiseHHMM) == 0 &&
+               strcmp(a.lastMoonSetHHMM, b.lastMoonSetHHMM) == 0 &&
+               strcmp(a.sunRiseTodayHHMM, b.sunRiseTodayHHMM) == 0 &&
+               strcmp(a.sunSetTodayHHMM, b.sunSetTodayHHMM) == 0 &&
+               a.minutesSinceSunRise == b.minutesSinceSunRise &&
+               a.minutesSinceSunSet == b.minutesSinceSunSet &&
+               a.minutesUntilSunSet == b.minutesUntilSunSet &&
+               a.minutesUntilSunRise == b.minutesUntilSunRise &&
+               std::abs(a.sunAltitudeAtRise - b.sunAltitudeAtRise) <= angleTolerance &&
+               std::abs(a.sunAzimuthAtRise - b.sunAzimuthAtRise) <= angleTolerance &&
+               std::abs(a.moonAltitudeAtRise - b.moonAltitudeAtRise) <= angleTolerance &&
+               std::abs(a.moonAzimuthAtRise - b.moonAzimuthAtRise) <= angleTolerance &&
+               a.minutesSunVisible == b.minutesSunVisible &&
+               a.minutesMoonVisible == b.minutesMoonVisible &&
+               a.moonPhaseIndex == b.moonPhaseIndex;
+    }
+
+    bool testSerializerRoundTrip() {
+        std::cout << "Testing serializer round trip..." << std::endl;
+
+        char json[AstronomySerializer::JSON_MAX_SIZE];
+        uint8_t binary[AstronomySerializer::BINARY_SIZE];
+        time_t start = createTimestamp(2026, 1, 1);
+
+        for (const auto& location : locations) {
+            for (int day = 0; day < 60; day++) {
+                AstronomyCalculator astro(location.latitude, location.longitude, start + (time_t)day * 86400 + day * 1733);
+                AstronomyRecord record(astro);
+                AstronomyRecord decoded;
+
+                size_t jsonLength = AstronomySerializer::writeJson(record, json, sizeof(json));
+                if (jsonLength == 0 || !AstronomySerializer::readJson(json, jsonLength, &decoded) ||
+                    !recordsMatch(record, decoded)) {
+                    std::cout << "  ❌ JSON round trip failed for " << location.name << ": " << json << std::endl;
+                    return false;
+                }
+
+                if (astro.sunRiseTodayHHMM != decoded.sunRiseTodayHHMM || astro.moonPhase() != decoded.moonPhase()) {
+                    std::cout << "  ❌ Record does not reflect calculator for " << location.name << std::endl;
+                    return false;
+                }
+
+                size_t binaryLength = AstronomySerializer::writeBinary(record, binary, sizeof(binary));
+                if (binaryLength != AstronomySerializer::BINARY_SIZE ||
+                    !AstronomySerializer::readBinary(binary, binaryLength, &decoded) ||
+                    !recordsMatch(record, decoded)) {
+                    std::cout << "  ❌ Binary round trip failed for " << location.name << std::endl;
+                    return false;
+                }
+
+                // Chunked output must equal the single-buffer output
+                std::string chunked;
+                char scratch[7];
+                if (!AstronomySerializer::writeJson(record, collectChunks, &chunked, scratch, sizeof(scratch)) ||
+                    chunked != std::string(json, jsonLength)) {
+                    std::cout << "  ❌ Chunked JSON differs from buffered JSON" << std::endl;
+                    return false;
+                }
+            }
+        }
+
+        // Worst-case values must fit the documented bound; short buffers fail cleanly
+        AstronomyRecord extreme = AstronomyRecord();
+        extreme.minutesSinceLastMoonRise = extreme.minutesSinceLastMoonSet = INT_MIN;
+        extreme.minutesUntilNextMoonRise = extreme.minutesUntilNextMoonSet = INT_MIN;
+        extreme.minutesSinceSunRise = extreme.minutesSinceSunSet = INT_MIN;
+        extreme.minutesUntilSunSet = extreme.minutesUntilSunRise = INT_MIN;
+        extreme.minutesSunVisible = extreme.minutesMoonVisible = INT_MIN;
+        extreme.sunAltitudeAtRise = extreme.sunAzimuthAtRise = -1e9;
+        extreme.moonAltitudeAtRise = extreme.moonAzimuthAtRise = -1e9;
+        strcpy(extreme.nextMoonRiseHHMM, "2359");
+        strcpy(extreme.nextMoonSetHHMM, "2359");
+        strcpy(extreme.lastMoonRiseHHMM, "2359");
+        strcpy(extreme.lastMoonSetHHMM, "2359");
+        strcpy(extreme.sunRiseTodayHHMM, "2359");
+        strcpy(extreme.sunSetTodayHHMM, "2359");
+        extreme.moonPhaseIndex = 1; // longest name
+        extreme.isMoonVisible = false;
+
+        size_t extremeLength = AstronomySerializer::writeJson(extreme, json, sizeof(json));
+        if (extremeLength == 0 || AstronomySerializer::writeJson(extreme, json, extremeLength - 1) != 0) {
+            std::cout << "  ❌ JSON size bound or overflow handling wrong (" << extremeLength << " bytes)" << std::endl;
+            return false;
+        }
+
+        // CSV rows line up with the header and fit their bound
+        char header[AstronomySerializer::JSON_MAX_SIZE];
+        char csv[AstronomySerializer::CSV_MAX_SIZE];
+        size_t headerLength = AstronomySerializer::writeCsvHeader(header, sizeof(header));
+        size_t csvLength = AstronomySerializer::writeCsv(extreme, csv, sizeof(csv));
+        AstronomyRecord sample(AstronomyCalculator(40.7128, -74.0060, start));
+        size_t sampleLength = AstronomySerializer::writeCsv(sample, json, sizeof(json));
+        if (headerLength == 0 || csvLength == 0 || sampleLength == 0 ||
+            std::count(header, header + headerLength, ',') != std::count(csv, csv + csvLength, ',') ||
+            std::count(header, header + headerLength, ',') != std::count(json, json + sampleLength, ',') ||
+            std::string(json).find(sample.sunRiseTodayHHMM) == std::string::npos ||
+            AstronomySerializer::writeCsv(extreme, csv, csvLength - 1) != 0) {
+            std::cout << "  ❌ CSV header/row mismatch or size bound wrong (" << csvLength << " bytes)" << std::endl;
+            return false;
+        }
+
+        // Incomplete, duplicated or out-of-range input is malformed
+        size_t sampleJsonLength = AstronomySerializer::writeJson(sample, json, sizeof(json));
+        std::string valid(json, sampleJsonLength);
+        size_t phaseKey = valid.find(",\"moonPhase\"");
+        size_t altitude = valid.find("\"sunAltitudeAtRise\":") + strlen("\"sunAltitudeAtRise\":");
+        std::string missing = valid.substr(0, phaseKey) + "}";
+        std::string duplicate = valid.substr(0, valid.size() - 1) + ",\"minutesSunVisible\":1}";
+        std::string overflow = valid.substr(0, altitude) + "100000000000000000" +
+                               valid.substr(valid.find(',', altitude));
+        const std::string malformed[] = { "{}", missing, duplicate, overflow };
+        AstronomyRecord decoded;
+        for (const std::string& text : malformed) {
+            if (AstronomySerializer::readJson(text.data(), text.size(), &decoded)) {
+                std::cout << "  ❌ Malformed JSON accepted: " << text << std::endl;
+                return false;
+            }
+        }
+        if (!AstronomySerializer::readJson(valid.data(), valid.size(), &decoded)) {
+            std::cout << "  ❌ Valid JSON rejected: " << valid << std::endl;
+            return false;
+        }
+
+        std::cout << "  ✅ JSON, CSV and binary output match (max JSON " << extremeLength << " bytes, CSV "
+                  << csvLength << " bytes, binary " << AstronomySerializer::BINARY_SIZE << " bytes)" << std::endl;
+        return true;
+    }
+
+    void benchmarkSerializer() {
+        const int iterations = 200000;
+        AstronomyCalculator astro(40.7128, -74.0060, createTimestamp(2026, 1, 1));
+        AstronomyRecord record(astro);
+        char json[AstronomySerializer::JSON_MAX_SIZE];
+        uint8_t binary[AstronomySerializer::BINARY_SIZE];
+        volatile size_t sink = 0;
+
+        auto begin = std::chrono::steady_clock::now();
+        for (int i = 0; i < iterations; i++) {
+            record.minutesSinceSunRise = i;
+            sink += AstronomySerializer::writeJson(record, json, sizeof(json));
+        }
+        auto middle = std::chrono::steady_clock::now();
+        for (int i = 0; i < iterations; i++) {
+            record.minutesSinceSunRise = i;
+            sink += AstronomySerializer::writeBinary(record, binary, sizeof(binary));
+        }
+        auto end = std::chrono::steady_clock::now();
+
+        size_t jsonBytes = AstronomySerializer::writeJson(record, json, sizeof(json));
+        double jsonSeconds = std::chrono::duration<double>(middle - begin).count();
+        double binarySeconds = std::chrono::duration<double>(end - middle).count();
+
+        std::cout << "Serializer, host (" << iterations << " records):" << std::endl;
+        std::cout << "  JSON:   " << std::fixed << std::setprecision(1)
+                  << jsonBytes * iterations / jsonSeconds / 1e6 << " MB/s, "
+                  << iterations / jsonSeconds / 1e6 << " M records/s" << std::endl;
+        std::cout << "  binary: " << std::fixed << std::setprecision(1)
+                  << AstronomySerializer::BINARY_SIZE * iterations / binarySeconds / 1e6 << " MB/s, "
+                  << iterations / binarySeconds / 1e6 << " M records/s" << std::endl;
+    }
+
+    bool testMoonIllumination() {
+        std::cout << "Testing moon illumination API..." << std::endl;
+
+        time_t start = createTimestamp(2026, 1, 1);
+        for (int hour = 0; hour < 30 * 24; hour += 5) {
+            time_t t = start + (time_t)hour * 3600;
+            AstronomyCalculator astro(40.7128, -74.0060, t);
+            AstronomyCalculatorFixed fixed(40.7128, -74.0060, t);
+
+            double fraction = astro.moonIlluminatedFraction();
+            int index = astro.moonPhaseIndex();
+            if (fraction < 0.0 || fraction > 1.0) {
+                std::cout << "  ❌ Illuminated fraction out of range: " << fraction << std::endl;
+                return false;
+            }
+
+            // Named phases strictly between new and full must agree on direction
+            if ((index >= 1 && index <= 3 && !astro.isMoonWaxing()) ||
+                (index >= 5 && index <= 7 && astro.isMoonWaxing())) {
+                std::cout << "  ❌ " << astro.moonPhase() << " reported as "
+                          << (astro.isMoonWaxing() ? "waxing" : "waning") << std::endl;
+                return false;
+            }
+            if ((index == 0 && fraction > 0.05) || (index == 4 && fraction < 0.95)) {
+                std::cout << "  ❌ " << astro.moonPhase() << " with illuminated fraction " << fraction << std::endl;
+                return false;
+            }
+
+            double fixedFraction = (double)fixed.moonIlluminatedFraction() / AstronomyCalculatorFixed::Q30_ONE;
+            if (std::abs(fixedFraction - fraction) > 0.0001 || fixed.isMoonWaxing() != astro.isMoonWaxing()) {
+                std::cout << "  ❌ Fixed-point illumination differs: " << fixedFraction << " vs " << fraction << std::endl;
+                return false;
+            }
+        }
+
+        // Published lunations (UTC): full 2026-01-03 10:03, new 2026-01-18 19:52,
+        // full 2026-02-01 22:09, new 2026-02-17 12:01
+        struct { int day; int minute; bool full; } lunations[] = {
+            { 2, 10 * 60 + 3, true }, { 17, 19 * 60 + 52, false },
+            { 31, 22 * 60 + 9, true }, { 47, 12 * 60 + 1, false }
+        };
+        const time_t january1 = 1767225600; // 2026-01-01 00:00 UTC
+        for (const auto& lunation : lunations) {
+            time_t t = january1 + (time_t)lunation.day * 86400 + lunation.minute * 60;
+            AstronomyCalculator astro(40.7128, -74.0060, t);
+            AstronomyCalculatorFixed fixed(40.7128, -74.0060, t);
+            double fraction = astro.moonIlluminatedFraction();
+            double fixedFraction = (double)fixed.moonIlluminatedFraction() / AstronomyCalculatorFixed::Q30_ONE;
+            int expectedIndex = lunation.full ? 4 : 0;
+            bool lit = lunation.full ? (fraction > 0.97 && fixedFraction > 0.97) : (fraction < 0.03 && fixedFraction < 0.03);
+            if (!lit || astro.moonPhaseIndex() != expectedIndex || fixed.moonPhaseIndex() != expectedIndex) {
+                std::cout << "  ❌ Published " << (lunation.full ? "full" : "new") << " moon reported as "
+                          << astro.moonPhase() << " with illuminated fraction " << fraction << std::endl;
+                return false;
+            }
+
+            // The cached icon matches: full disk at full moon, dark at new moon
+            MoonRenderCache icons(32, 16);
+            int litPixels = countLitPixels(icons.frame(icons.frameIndex(astro.moonPhaseAngle())), icons.frameSize());
+            if (lunation.full ? litPixels < 700 : litPixels > 100) {
+                std::cout << "  ❌ Moon icon has " << litPixels << " lit pixels at "
+                          << (lunation.full ? "full" : "new") << " moon" << std::endl;
+                return false;
+            }
+        }
+
+        std::cout << "  ✅ Illumination matches published lunations and phase names" << std::endl;
+        return true;
+    }
+
+    int countLitPixels(const uint8_t* frame, size_t bytes) {
+        int lit = 0;
+        for (size_t i = 0; i < bytes; i++) {
+            for (uint8_t b = frame[i]; b != 0; b &= b - 1) lit++;
+        }
+        return lit;
+    }
+
+    bool testMoonRenderCache() {
+        std::cout << "Testing moon render cache..." << std::endl;
+
+        const int diameter = 64;
+        const int steps = 32;
+        MoonRenderCache cache(diameter, steps);
+
+        if (cache.memoryUsage() != (size_t)steps * diameter * 8) {
+            std::cout << "  ❌ Unexpected footprint " << cache.memoryUsage() << " bytes" << std::endl;
+            return false;
+        }
+
+        int disk = countLitPixels(cache.frame(steps / 2), cache.frameSize());
+        if (countLitPixels(cache.frame(0), cache.frameSize()) != 0 ||
+            std::abs(disk - M_PI * diameter * diameter / 4) > diameter) {
+            std::cout << "  ❌ New/full frames wrong: full disk has " << disk << " pixels" << std::endl;
+            return false;
+        }
+
+        std::vector<uint8_t> drawn(cache.frameSize());
+        std::vector<uint8_t> rendered(cache.frameSize());
+        for (int i = 0; i < steps; i++) {
+            double angle = 360.0 * i / steps;
+            double expected = (1.0 - cos(angle * M_PI / 180.0)) / 2.0;
+            double lit = (double)countLitPixels(cache.frame(i), cache.frameSize()) / disk;
+            if (std::abs(lit - expected) > 0.03) {
+                std::cout << "  ❌ Frame " << i << " lit fraction " << lit << ", expected " << expected << std::endl;
+                return false;
+            }
+
+            // Nearby angles snap to the same frame, by degrees or by BAM
+            double nearby = angle + 0.4 * 360.0 / steps;
+            cache.draw(nearby, drawn.data());
+            MoonRenderCache::render(angle, diameter, rendered.data());
+            uint32_t bam = (uint32_t)(nearby / 360.0 * 4294967296.0);
+            if (drawn != rendered || cache.frameIndex(nearby) != i || cache.frameIndexForAngle(bam) != i) {
+                std::cout << "  ❌ Cached frame " << i << " does not match direct rendering" << std::endl;
+                return false;
+            }
+        }
+
+        // Waxing frames light the right half first, waning frames the left
+        const uint8_t* firstQuarter = cache.frame(steps / 4);
+        const uint8_t* lastQuarter = cache.frame(3 * steps / 4);
+        int middleRow = diameter / 2;
+        if ((firstQuarter[middleRow * cache.bytesPerRow()] & 0x40) != 0 ||
+            (lastQuarter[middleRow * cache.bytesPerRow()] & 0x40) == 0) {
+            std::cout << "  ❌ Quarter frames lit on the wrong side" << std::endl;
+            return false;
+        }
+
+        std::cout << "  ✅ Render cache frames match direct rendering" << std::endl;
+        return true;
+    }
+
+    void benchmarkMoonRenderCache() {
+        const int diameter = 128;
+        const int steps = 64;
+        const int iterations = 20000;
+
+        auto buildStart = std::chrono::steady_clock::now();
+        MoonRenderCache cache(diameter, steps);
+        auto buildEnd = std::chrono::steady_clock::now();
+
+        std::vector<uint8_t> target(cache.frameSize());
+        volatile uint8_t sink = 0;
+
+        auto begin = std::chrono::steady_clock::now();
+        for (int i = 0; i < iterations; i++) {
+            cache.draw(i * 0.37, target.data());
+            sink += target[diameter];
+        }
+        auto middle = std::chrono::steady_clock::now();
+        for (int i = 0; i < iterations / 100; i++) {
+            MoonRenderCache::render(i * 0.37, diameter, target.data());
+            sink += target[diameter];
+        }
+        auto end = std::chrono::steady_clock::now();
+
+        double cachedUs = std::chrono::duration<double, std::micro>(middle - begin).count() / iterations;
+        double renderUs = std::chrono::duration<double, std::micro>(end - middle).count() / (iterations / 100);
+        double buildMs = std::chrono::duration<double, std::milli>(buildEnd - buildStart).count();
+
+        std::cout << "Moon render cache, host (" << diameter << "px, " << steps << " phases):" << std::endl;
+        std::cout << "  memory:       " << cache.memoryUsage() << " bytes (" << cache.frameSize() << " per frame)" << std::endl;
+        std::cout << "  build:        " << std::fixed << std::setprecision(2) << buildMs << " ms" << std::endl;
+        std::cout << "  cached draw:  " << std::fixed << std::setprecision(3) << cachedUs << " us" << std::endl;
+        std::cout << "  direct draw:  " << std::fixed << std::setprecision(3) << renderUs << " us" << std::endl;
+    }
+
+    bool testHorizonProfile() {
+        std::cout << "Testing horizon profile rise/set..." << std::endl;
+
+        HorizonProfile flat(360);
+        HorizonProfile raised(360);
+        HorizonProfile eastWall(360);
+        HorizonProfile westWall(360);
+        HorizonProfile solid(72);
+        for (int bin = 0; bin < 360; bin++) {
+            raised.setElevation(bin, 5.0);
+            if (bin >= 40 && bin <= 140) eastWall.setElevation(bin, 15.0);
+            if (bin >= 220 && bin <= 320) westWall.setElevation(bin, 15.0);
+        }
+        for (int bin = 0; bin < 72; bin++) {
+            solid.setElevation(bin, 89.0);
+        }
+
+        time_t start = createTimestamp(2026, 1, 1);
+        for (const auto& location : locations) {
+            for (int day = 0; day < 365; day += 7) {
+                time_t t = start + (time_t)day * 86400;
+                AstronomyCalculator plain(location.latitude, location.longitude, t);
+                AstronomyCalculator withFlat(location.latitude, location.longitude, t, &flat);
+                AstronomyCalculator withRaised(location.latitude, location.longitude, t, &raised);
+                AstronomyCalculator withEast(location.latitude, location.longitude, t, &eastWall);
+                AstronomyCalculator withWest(location.latitude, location.longitude, t, &westWall);
+                AstronomyCalculator withSolid(location.latitude, location.longitude, t, &solid);
+
+                // A flat zero profile reproduces the flat-horizon results
+                if (!clockWithinTolerance(withFlat.sunRiseTodayHHMM, plain.sunRiseTodayHHMM, 1) ||
+                    !clockWithinTolerance(withFlat.sunSetTodayHHMM, plain.sunSetTodayHHMM, 1) ||
+                    !clockWithinTolerance(withFlat.nextMoonSetHHMM, plain.nextMoonSetHHMM, 1) ||
+                    !clockWithinTolerance(withFlat.lastMoonRiseHHMM, plain.lastMoonRiseHHMM, 1)) {
+                    std::cout << "  ❌ Flat profile differs at " << location.name << " day " << day << ": sunrise "
+                              << withFlat.sunRiseTodayHHMM << " vs " << plain.sunRiseTodayHHMM << std::endl;
+                    return false;
+                }
+
+                // A uniformly raised horizon delays rise and advances set symmetrically
+                int riseDelay = clockMinutes(withRaised.sunRiseTodayHHMM) - clockMinutes(plain.sunRiseTodayHHMM);
+                int setAdvance = clockMinutes(plain.sunSetTodayHHMM) - clockMinutes(withRaised.sunSetTodayHHMM);
+                if (riseDelay < 15 || std::abs(riseDelay - setAdvance) > 1) {
+                    std::cout << "  ❌ Raised horizon at " << location.name << " day " << day << ": rise +"
+                              << riseDelay << " min, set -" << setAdvance << " min" << std::endl;
+                    return false;
+                }
+
+                // Obstructions only move the event on their side of the sky
+                int eastDelay = clockMinutes(withEast.sunRiseTodayHHMM) - clockMinutes(plain.sunRiseTodayHHMM);
+                int westAdvance = clockMinutes(plain.sunSetTodayHHMM) - clockMinutes(withWest.sunSetTodayHHMM);
+                if (eastDelay < riseDelay || !clockWithinTolerance(withEast.sunSetTodayHHMM, plain.sunSetTodayHHMM, 1) ||
+                    westAdvance < setAdvance || !clockWithinTolerance(withWest.sunRiseTodayHHMM, plain.sunRiseTodayHHMM, 1)) {
+                    std::cout << "  ❌ Walls at " << location.name << " day " << day << ": east +" << eastDelay
+                              << " min, west -" << westAdvance << " min" << std::endl;
+                    return false;
+                }
+
+                if (!withSolid.sunRiseTodayHHMM.empty() || withSolid.minutesSunVisible != 0) {
+                    std::cout << "  ❌ Sun rose over an 89 degree horizon at " << location.name << std::endl;
+                    return false;
+                }
+            }
+        }
+
+        // Visibility follows the profile too: a moon below a high horizon is
+        // not visible, and its next rise is reported
+        HorizonProfile high(360);
+        for (int bin = 0; bin < 360; bin++) {
+            high.setElevation(bin, 30.0);
+        }
+        int hiddenSamples = 0;
+        for (const auto& location : locations) {
+            for (int hour = 0; hour < 30 * 24; hour += 5) {
+                time_t t = start + (time_t)hour * 3600;
+                AstronomyCalculator withHigh(location.latitude, location.longitude, t, &high);
+                double azimuth;
+                double altitude = withHigh.moonAltitudeAt(t, &azimuth);
+                bool above = altitude > 30.0 - 0.567;
+                bool hiddenByProfile = altitude > 0.0 && !above;
+                if (hiddenByProfile) hiddenSamples++;
+                if (withHigh.isMoonVisible != above ||
+                    (!above && withHigh.minutesUntilNextMoonRise >= 0 && withHigh.nextMoonRiseHHMM.empty())) {
+                    std::cout << "  ❌ Moon at " << altitude << " degrees behind a 30 degree horizon at "
+                              << location.name << " hour " << hour << ": visible " << withHigh.isMoonVisible
+                              << ", next rise '" << withHigh.nextMoonRiseHHMM << "' in "
+                              << withHigh.minutesUntilNextMoonRise << " min" << std::endl;
+                    return false;
+                }
+            }
+        }
+        if (hiddenSamples == 0) {
+            std::cout << "  ❌ No samples with the moon behind the profile" << std::endl;
+            return false;
+        }
+
+        // Compact file format round trip, in memory and through a file
+        std::vector<uint8_t> bytes(HorizonProfile::fileSize(eastWall.binCount()));
+        HorizonProfile loaded;
+        HorizonProfile fromFile;
+        const char* path = "horizon_profile_test.hzn";
+        size_t written = eastWall.save(bytes.data(), bytes.size());
+        FILE* file = fopen(path, "wb");
+        bool fileOk = file != nullptr && fwrite(bytes.data(), 1, written, file) == written;
+        if (file != nullptr) fclose(file);
+        fileOk = fileOk && fromFile.loadFile(path);
+        remove(path);
+
+        if (written != 726 || !loaded.load(bytes.data(), written) || !fileOk ||
+            loaded.binCount() != 360 || fromFile.binCount() != 360) {
+            std::cout << "  ❌ Horizon profile save/load failed" << std::endl;
+            return false;
+        }
+        for (int bin = 0; bin < 360; bin++) {
+            if (loaded.elevation(bin) != eastWall.elevation(bin) || fromFile.elevation(bin) != eastWall.elevation(bin)) {
+                std::cout << "  ❌ Horizon profile bin " << bin << " changed on reload" << std::endl;
+                return false;
+            }
+        }
+        if (std::abs(eastWall.elevationAt(139.5) - 15.0) > 1e-9 || std::abs(eastWall.elevationAt(140.5) - 7.5) > 1e-9) {
+            std::cout << "  ❌ Azimuth interpolation wrong" << std::endl;
+            return false;
+        }
+
+        bytes[0] = 'X';
+        if (loaded.load(bytes.data(), written) || loaded.load(bytes.data(), 5)) {
+            std::cout << "  ❌ Corrupt horizon profile accepted" << std::endl;
+            return false;
+        }
+
+        std::cout << "  ✅ Horizon profiles shift rise/set as expected" << std::endl;
+        return true;
+    }
+
+    void benchmarkHorizonProfile() {
+        const int iterations = 5000;
+        HorizonProfile coarse(360);
+        HorizonProfile fine(HorizonProfile::MAX_BINS);
+        for (int bin = 0; bin < coarse.binCount(); bin++) {
+            coarse.setElevation(bin, 8.0 + 6.0 * sin(bin * 0.3));
+        }
+        for (int bin = 0; bin < fine.binCount(); bin++) {
+            fine.setElevation(bin, 8.0 + 6.0 * sin(bin * 0.03));
+        }
+
+        const HorizonProfile* profiles[] = { nullptr, &coarse, &fine };
+        const char* labels[] = { "flat:      ", "360 bins:  ", "3600 bins: " };
+        time_t start = createTimestamp(2026, 1, 1);
+        volatile int sink = 0;
+
+        std::cout << "Horizon profile rise/set, host (" << iterations << " constructions):" << std::endl;
+        for (int p = 0; p < 3; p++) {
+            auto begin = std::chrono::steady_clock::now();
+            for (int i = 0; i < iterations; i++) {
+                AstronomyCalculator astro(40.7128, -74.0060, start + (time_t)i * 3607, profiles[p]);
+                sink += astro.minutesSunVisible;
+            }
+            auto end = std::chrono::steady_clock::now();
+            std::cout << "  " << labels[p] << std::fixed << std::setprecision(2)
+                      << std::chrono::duration<double, std::micro>(end - begin).count() / iterations << " us" << std::endl;
+        }
+        (void)sink;
+    }
+
+    // Worst interpolation error over a span, checked at whole seconds
+    double skyInterpolationError(double lat, double lng, time_t start, int seconds, int stride,
+                                 double maxError, int* segmentsBuilt) {
+        SkyInterpolator sky(lat, lng, start, 300, maxError);
+        AstronomyCalculator exact(lat, lng, start);
+        double worst = 0.0;
+        *segmentsBuilt = SkyInterpolator::CAPACITY;
+
+        for (int offset = 0; offset < seconds; offset += stride) {
+            time_t t = start + offset;
+            SkyPosition position;
+            if (!sky.sample((int64_t)t * 1000, &position)) return 1e9;
+            while (sky.refresh()) (*segmentsBuilt)++;
+
+            double sunAzimuth, moonAzimuth;
+            double sunAltitude = exact.sunAltitudeAt(t, &sunAzimuth);
+            double moonAltitude = exact.moonAltitudeAt(t, &moonAzimuth);
+
+            worst = std::max(worst, std::abs(position.sunAltitude - sunAltitude));
+            worst = std::max(worst, std::abs(position.moonAltitude - moonAltitude));
+            double sunError = std::fmod(std::abs(position.sunAzimuth - sunAzimuth), 360.0);
+            double moonError = std::fmod(std::abs(position.moonAzimuth - moonAzimuth), 360.0);
+            worst = std::max(worst, std::min(sunError, 360.0 - sunError));
+            worst = std::max(worst, std::min(moonError, 360.0 - moonError));
+        }
+        return worst;
+    }
+
+    // Worst distance outside the exact values at the surrounding whole
+    // seconds, sampled at 60 fps frame times; *worstMillis is where it was
+    double skyFrameOvershoot(double lat, double lng, time_t start, int seconds, double maxError, int64_t* worstMillis) {
+        SkyInterpolator sky(lat, lng, start, 300, maxError);
+        AstronomyCalculator exact(lat, lng, start);
+        double worst = 0.0;
+        *worstMillis = 0;
+
+        double before[4], after[4];
+        before[0] = exact.sunAltitudeAt(start, &before[1]);
+        before[2] = exact.moonAltitudeAt(start, &before[3]);
+        int64_t frame = 0;
+        for (int offset = 0; offset < seconds; offset++) {
+            after[0] = exact.sunAltitudeAt(start + offset + 1, &after[1]);
+            after[2] = exact.moonAltitudeAt(start + offset + 1, &after[3]);
+
+            for (;; frame++) {
+                int64_t millis = frame * 50 / 3; // 60 fps
+                if (millis >= (int64_t)(offset + 1) * 1000) break;
+                SkyPosition position;
+                if (!sky.sample((int64_t)start * 1000 + millis, &position)) return 1e9;
+                while (sky.refresh()) {
+                }
+
+                const double values[4] = { position.sunAltitude, position.sunAzimuth,
+                                           position.moonAltitude, position.moonAzimuth };
+                for (int channel = 0; channel < 4; channel++) {
+                    // Azimuths are measured from the earlier second, the short way round
+                    double low = 0.0, high = after[channel] - before[channel];
+                    double value = values[channel] - before[channel];
+                    if (channel == 1 || channel == 3) {
+                        high = std::remainder(high, 360.0);
+                        value = std::remainder(value, 360.0);
+                    }
+                    if (high < low) std::swap(low, high);
+                    double outside = std::max(low - value, value - high);
+                    if (outside > worst) {
+                        worst = outside;
+                        *worstMillis = millis;
+                    }
+                }
+            }
+            std::copy(after, after + 4, before);
+        }
+        return worst;
+    }
+
+    bool testSkyInterpolator() {
+        std::cout << "Testing sky interpolator error bound..." << std::endl;
+
+        const double maxError = 0.01;
+        time_t start = createTimestamp(2026, 6, 15) - 12 * 3600; // midnight, no DST change
+
+        std::vector<TestLocation> sites = locations;
+        sites.push_back({"Sydney", -33.8688, 151.2093});
+        sites.push_back({"Quito", -0.1807, -78.4678});
+
+        for (const auto& site : sites) {
+            int segmentsBuilt;
+            double worst = skyInterpolationError(site.latitude, site.longitude, start, 86400, 3, maxError, &segmentsBuilt);
+            if (worst > maxError) {
+                std::cout << "  ❌ " << site.name << ": max error " << std::setprecision(5) << worst << " degrees exceeds " << maxError << std::endl;
+                return false;
+            }
+
+            // Between whole seconds, at frame times, nothing overshoots the
+            // model, including across its azimuth jumps at sunrise and sunset
+            int64_t worstMillis;
+            double overshoot = skyFrameOvershoot(site.latitude, site.longitude, start, 86400, maxError, &worstMillis);
+            if (overshoot > maxError) {
+                std::cout << "  ❌ " << site.name << ": frame at +" << worstMillis / 1000.0 << " s is "
+                          << std::setprecision(5) << overshoot << " degrees outside the model" << std::endl;
+                return false;
+            }
+        }
+
+        // Outside the buffered window the caller is told to fall back
+        SkyInterpolator sky(40.7128, -74.0060, start);
+        SkyPosition position;
+        int64_t end = sky.bufferedEnd();
+        if (sky.bufferedStart() != start ||
+            sky.sample((int64_t)(start - 1) * 1000, &position) ||
+            !sky.sample((end - 1) * 1000, &position) ||
+            sky.sample(end * 1000, &position)) {
+            std::cout << "  ❌ Sampling outside the buffered window not rejected" << std::endl;
+            return false;
+        }
+
+        std::cout << "  ✅ Interpolated sky within " << std::setprecision(2) << maxError << " degrees over 24h at " << sites.size() << " sites" << std::endl;
+        return true;
+    }
+
+    void benchmarkSkyInterpolator() {
+        const int frames = 60 * 60 * 10; // ten minutes at 60 fps
+        time_t start = createTimestamp(2026, 6, 15);
+        SkyInterpolator sky(40.7128, -74.0060, start);
+        AstronomyCalculator exact(40.7128, -74.0060, start);
+        volatile float sink = 0;
+
+        auto begin = std::chrono::steady_clock::now();
+        for (int frame = 0; frame < frames; frame++) {
+            SkyPosition position;
+            sky.sample((int64_t)start * 1000 + frame * 1000 / 60, &position);
+            sink += position.sunAltitude + position.moonAzimuth;
+        }
+        auto middle = std::chrono::steady_clock::now();
+        for (int frame = 0; frame < frames; frame++) {
+            double sunAzimuth, moonAzimuth;
+            sink += (float)exact.sunAltitudeAt(start + frame / 60, &sunAzimuth);
+            sink += (float)exact.moonAltitudeAt(start + frame / 60, &moonAzimuth);
+        }
+        auto end = std::chrono::steady_clock::now();
+
+        int segmentsBuilt;
+        double worst = skyInterpolationError(40.7128, -74.0060, start, 86400, 1, 0.01, &segmentsBuilt);
+
+        std::cout << "Sky interpolator, host (" << frames << " frames at 60 fps):" << std::endl;
+        std::cout << "  interpolated: " << std::fixed << std::setprecision(3)
+                  << std::chrono::duration<double, std::micro>(middle - begin).count() / frames << " us/frame" << std::endl;
+        std::cout << "  exact:        " << std::fixed << std::setprecision(3)
+                  << std::chrono::duration<double, std::micro>(end - middle).count() / frames << " us/frame" << std::endl;
+        std::cout << "  max error:    " << std::setprecision(5) << worst << " degrees over 24h, "
+                  << segmentsBuilt << " segments" << std::endl;
+    }
+
+    bool testAstronomyCache() {
+        std::cout << "Testing sharded result cache..." << std::endl;
+
+        time_t noon = createTimestamp(2026, 6, 15);
+
+        time_t midnight = noon - 12 * 3600;
+
+        // On the quantization grid, and for any coordinates with quantum 0,
+        // hits at every hour reproduce the uncached calculator exactly
+        AstronomyCache grid(64, 0.25, 4);
+        AstronomyCache exactCache(64, 0.0, 4);
+        for (int hour = 0; hour < 24; hour++) {
+            time_t t = midnight + hour * 3600 + 1234;
+            if (!recordsMatch(grid.lookup(40.75, -74.0, t), AstronomyRecord(AstronomyCalculator(40.75, -74.0, t))) ||
+                !recordsMatch(exactCache.lookup(40.7128, -74.0060, t),
+                              AstronomyRecord(AstronomyCalculator(40.7128, -74.0060, t)))) {
+                std::cout << "  ❌ Hour " << hour << ": cached record differs from the calculator" << std::endl;
+                return false;
+            }
+        }
+        AstronomyCache::Stats stats = exactCache.stats();
+        if (stats.misses != 1 || stats.hits != 23 || stats.entries != 1) {
+            std::cout << "  ❌ Expected 1 miss and 23 hits, got " << stats.misses << " and " << stats.hits << std::endl;
+            return false;
+        }
+
+        // Off the grid, rise/set stay within the documented 2 minutes
+        AstronomyCache cache(256, 0.01, 4);
+        std::vector<TestLocation> sites = locations;
+        sites.push_back({"Sydney", -33.8688, 151.2093});
+        sites.push_back({"Quito", -0.1807, -78.4678});
+        for (const auto& site : sites) {
+            for (int hour = 0; hour < 24 * 5; hour += 5) {
+                time_t t = midnight + hour * 3600 + 1234;
+                AstronomyRecord cached = cache.lookup(site.latitude + 0.0043, site.longitude - 0.0041, t);
+                AstronomyRecord exact(AstronomyCalculator(site.latitude + 0.0043, site.longitude - 0.0041, t));
+                const char* fields[][2] = {
+                    { cached.sunRiseTodayHHMM, exact.sunRiseTodayHHMM }, { cached.sunSetTodayHHMM, exact.sunSetTodayHHMM },
+                    { cached.nextMoonRiseHHMM, exact.nextMoonRiseHHMM }, { cached.nextMoonSetHHMM, exact.nextMoonSetHHMM },
+                    { cached.lastMoonRiseHHMM, exact.lastMoonRiseHHMM }, { cached.lastMoonSetHHMM, exact.lastMoonSetHHMM }
+                };
+                for (const auto& field : fields) {
+                    if (!clockWithinTolerance(field[0], field[1], 2)) {
+                        std::cout << "  ❌ " << site.name << " hour " << hour << ": cached " << field[0]
+                                  << " vs uncached " << field[1] << std::endl;
+                        return false;
+                    }
+                }
+                if (std::abs(cached.minutesUntilSunSet - exact.minutesUntilSunSet) > 2 ||
+                    std::abs(cached.minutesUntilNextMoonRise - exact.minutesUntilNextMoonRise) > 2 ||
+                    cached.isMoonVisible != exact.isMoonVisible || cached.moonPhaseIndex != exact.moonPhaseIndex) {
+                    std::cout << "  ❌ " << site.name << " hour " << hour << ": cached relative fields differ" << std::endl;
+                    return false;
+                }
+            }
+        }
+
+        // Least recently used day is evicted first
+        AstronomyCache small(4, 0.01, 1);
+        for (int day = 0; day < 6; day++) small.lookup(40.7128, -74.0060, noon + day * 86400);
+        small.lookup(40.7128, -74.0060, noon + 5 * 86400);
+        small.lookup(40.7128, -74.0060, noon);
+        stats = small.stats();
+        if (stats.evictions != 3 || stats.entries != 4 || stats.hits != 1 || stats.misses != 7) {
+            std::cout << "  ❌ LRU bookkeeping wrong: " << stats.hits << " hits, " << stats.misses << " misses, "
+                      << stats.evictions << " evictions" << std::endl;
+            return false;
+        }
+
+        // The bound holds even with more shards than entries
+        AstronomyCache tiny(4, 0.01, 16);
+        for (int day = 0; day < 10; day++) tiny.lookup(40.7128, -74.0060, noon + day * 86400);
+        stats = tiny.stats();
+        if (tiny.capacity() != 4 || stats.entries != 4 || stats.evictions != 6) {
+            std::cout << "  ❌ Capacity 4 cache holds " << stats.entries << " entries after "
+                      << stats.evictions << " evictions" << std::endl;
+            return false;
+        }
+
+        // Concurrent lookups at arbitrary hours agree with the calculator and every lookup is counted
+        const int threads = 4, perThread = 3000, keys = 40;
+        AstronomyCache shared(16, 0.0, 4);
+        std::vector<AstronomyRecord> reference;
+        auto keyTime = [&](int k) { return noon + (k % 3) * 86400 + (k * 3797) % 43200 - 21600; };
+        for (int k = 0; k < keys; k++) {
+            reference.push_back(AstronomyRecord(AstronomyCalculator(30.0123 + k * 0.5, -100.0 + k, keyTime(k))));
+        }
+        std::atomic<int> mismatches(0);
+        std::vector<std::thread> workers;
+        for (int w = 0; w < threads; w++) {
+            workers.emplace_back([&, w]() {
+                for (int i = 0; i < perThread; i++) {
+                    int k = (i * 7 + w * 13) % keys;
+                    AstronomyRecord record = shared.lookup(30.0123 + k * 0.5, -100.0 + k, keyTime(k));
+                    if (!recordsMatch(record, reference[k])) mismatches++;
+                }
+            });
+        }
+        for (auto& worker : workers) worker.join();
+        stats = shared.stats();
+        if (mismatches != 0 || stats.hits + stats.misses != (uint64_t)(threads * perThread) || stats.entries > shared.capacity()) {
+            std::cout << "  ❌ Concurrent lookups: " << mismatches << " mismatches, "
+                      << stats.hits + stats.misses << " counted" << std::endl;
+            return false;
+        }
+
+        std::cout << "  ✅ Cache hits, evictions and concurrent lookups behave as expected" << std::endl;
+        return true;
+    }
+
+    bool testQueryParser() {
+        std::cout << "Testing batch query parser..." << std::endl;
+        int failures = 0;
+        auto check = [&](bool condition, const std::string& what) {
+            if (!condition) {
+                if (failures < 5) std::cout << "  ❌ " << what << std::endl;
+                failures++;
+            }
+        };
+        auto time = [](const char* text, int64_t* result) {
+            return AstronomyQueryParser::parseTime(text, text + strlen(text), result);
+        };
+        auto csv = [](const char* text, AstronomyQuery* query) {
+            return AstronomyQueryParser::parseCsv(text, strlen(text), query);
+        };
+        auto ndjson = [](const char* text, AstronomyQuery* query) {
+            return AstronomyQueryParser::parseNdjson(text, strlen(text), query);
+        };
+
+        // Times: Unix seconds, local dates at noon, UTC and local clock times
+        int64_t t = 0;
+        check(time("1781524800", &t) && t == 1781524800, "Unix seconds");
+        check(time(" 2026-06-15 ", &t) && t == createTimestamp(2026, 6, 15), "local date at noon");
+        check(time("2026-06-15T00:00Z", &t) && t == 1781481600, "UTC clock time");
+        check(time("2000-02-29T06:30:15Z", &t) && t == 951805815, "leap day with seconds");
+        check(time("2024-02-29", &t), "leap day");
+        for (const char* bad : { "2026-02-29", "2026-02-31", "2026-04-31", "1900-02-29", "2026-13-01",
+                                 "2026-00-10", "2026-06-00", "2026-06-15T24:00", "2026-06-15T12:60",
+                                 "2026-06-15T12:00Zx", "2026-6-15", "12x", "" }) {
+            check(!time(bad, &t), std::string("time rejected: ") + bad);
+        }
+
+        // CSV lines
+        AstronomyQuery query;
+        check(csv("40.5, -74 ,1781524800", &query) && query.lat == 40.5 && query.lng == -74.0 &&
+              query.from == 1781524800 && query.to == query.from &&
+              query.step == AstronomyQueryParser::DEFAULT_STEP, "CSV single time");
+        check(csv("40,-74,2026-01-01,2026-01-31,3600.9", &query) && query.step == 3600 &&
+              query.to - query.from == 30 * 86400, "CSV range with fractional step");
+        check(csv("40,-74,2026-01-01,2026-01-31", &query) && query.step == 86400, "CSV range default step");
+        for (const char* bad : { "40,-74,2026-02-31", "40,-74,2026-01-01,2026-02-30", "40,-74,2026-01-01,2026-01-31,1e300",
+                                 "40,-74,2026-01-01,2026-01-31,nan", "40,-74,2026-01-01,2026-01-31,inf",
+                                 "40,-74,2026-01-01,2026-01-31,-5", "40,-74,2026-01-01,2026-01-31,0.5",
+                                 "40,-74,2026-01-01,2026-01-31,9.3e18", "40,-74,2026-01-31,2026-01-01",
+                                 "91,0,1781524800", "40,181,1781524800", "40,-74", "40,-74,1,2,3,4",
+                                 "lat,lng,time" }) {
+            check(!csv(bad, &query), std::string("CSV rejected: ") + bad);
+        }
+
+        // NDJSON lines
+        check(ndjson("{\"lat\":40.7,\"lng\":-74,\"time\":\"2026-06-15\",\"name\":\"x\"}", &query) &&
+              query.lat == 40.7 && query.from == createTimestamp(2026, 6, 15) && query.to == query.from,
+              "NDJSON single time");
+        check(ndjson(" { \"lat\": 40.7, \"lon\": -74, \"from\": \"2026-01-01\", \"to\": \"2026-01-02\", \"step\": 3600 }",
+                     &query) && query.lng == -74.0 && query.step == 3600 && query.to - query.from == 86400,
+              "NDJSON range");
+        for (const char* bad : { "{\"lat\":40.7,\"lng\":-74,\"time\":\"2026-02-30\"}",
+                                 "{\"lat\":40.7,\"lng\":-74,\"from\":1,\"to\":2,\"step\":1e300}",
+                                 "{\"lat\":40.7,\"lng\":-74,\"from\":1,\"to\":2,\"step\":nan}",
+                                 "{\"lat\":40.7,\"lng\":-74,\"from\":1,\"to\":2,\"step\":0}",
+                                 "{\"lat\":40.7,\"time\":1781524800}",
+                                 "{\"lat\":40.7,\"lng\":-74,\"time\":1,\"from\":1,\"to\":2}",
+                                 "{\"lat\":40.7,\"lng\":-74,\"time\":1781524800",
+                                 "[40.7,-74,1781524800]" }) {
+            check(!ndjson(bad, &query), std::string("NDJSON rejected: ") + bad);
+        }
+
+        if (failures > 0) {
+            std::cout << "  ❌ " << failures << " parser checks failed" << std::endl;
+            return false;
+        }
+        std::cout << "  ✅ Times, CSV and NDJSON queries parse and reject as expected" << std::endl;
+        return true;
+    }
+
+    void benchmarkAstronomyCache() {
+        const int perThread = 20000, sites = 500;
+        time_t noon = createTimestamp(2026, 6, 15);
+        unsigned hardware = std::max(1u, std::thread::hardware_concurrency());
+
+        // Repeat traffic: a few hundred sites, requests spread over one day
+        auto query = [&](int i, double* lat, double* lng, time_t* t) {
+            int site = (i * 2654435761u) % sites;
+            *lat = -50.0 + site * 0.2;
+            *lng = -170.0 + site * 0.68;
+            *t = noon - 6 * 3600 + (i * 37) % (12 * 3600);
+        };
+
+        // Same thread counts on every host so runs are comparable
+        std::cout << "Result cache, host (" << perThread << " lookups/thread, " << sites << " sites, "
+                  << hardware << " hardware threads):" << std::endl;
+        const unsigned threadCounts[] = {1, 2, 4, 8};
+
+        for (unsigned threads : threadCounts) {
+            AstronomyCache cache(4096);
+            double rates[2];
+            for (int cached = 0; cached < 2; cached++) {
+                std::atomic<int> sink(0);
+                auto begin = std::chrono::steady_clock::now();
+                std::vector<std::thread> workers;
+                for (unsigned w = 0; w < threads; w++) {
+                    workers.emplace_back([&, w]() {
+                        int local = 0;
+                        for (int i = 0; i < perThread; i++) {
+                            double lat, lng;
+                            time_t t;
+                            query(i + w * perThread, &lat, &lng, &t);
+                            AstronomyRecord record = cached ? cache.lookup(lat, lng, t)
+                                                            : AstronomyRecord(AstronomyCalculator(lat, lng, t));
+                            local += record.minutesSunVisible;
+                        }
+                        sink += local;
+                    });
+                }
+                for (auto& worker : workers) worker.join();
+                double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+                rates[cached] = threads * perThread / seconds;
+            }
+            AstronomyCache::Stats stats = cache.stats();
+            std::cout << "  " << threads << " thread(s): uncached " << std::fixed << std::setprecision(0) << rates[0]
+                      << "/s, cached " << rates[1] << "/s (" << std::setprecision(1)
+                      << 100.0 * stats.hits / (stats.hits + stats.misses) << "% hits)" << std::endl;
+        }
+    }
+
+    template <typename Calculator>
+    double microsecondsPerConstruction(int iterations) {
+        time_t start = createTimestamp(2026, 1, 1);
+        volatile int sink = 0;
+
+        auto begin = std::chrono::steady_clock::now();
+        for (int i = 0; i < iterations; i++) {
+            Calculator astro(40.7128, -74.0060, start + (time_t)i * 3607);
+            sink += astro.minutesSunVisible;
+        }
+        auto end = std::chrono::steady_clock::now();
+
+        (void)sink;
+        return std::chrono::duration<double, std::micro>(end - begin).count() / iterations;
+    }
+
+    void benchmarkFixedPoint() {
+        const int iterations = 20000;
+        double doubleUs = microsecondsPerConstruction<AstronomyCalculator>(iterations);
+        double fixedUs = microsecondsPerConstruction<AstronomyCalculatorFixed>(iterations);
+
+        std::cout << "Full calculation, host (" << iterations << " iterations):" << std::endl;
+        std::cout << "  double:      " << std::fixed << std::setprecision(2) << doubleUs << " us" << std::endl;
+        std::cout << "  fixed-point: " << std::fixed << std::setprecision(2) << fixedUs << " us" << std::endl;
+        std::cout << "  (host has an FPU; the fixed-point gain shows on FPU-less targets)" << std::endl;
+    }
 };
 
 // Native test runner